@@ -6,6 +6,99 @@
 #include "AdvancedRules.h"
 namespace AdvancedRules {
 
+/**
+ * Creates a Gauss-Legendre table for a number of points, laid out as GSL's (the
+ * nonnegative nodes in ascending order, with their weights).
+ * Small tables come from GSL, but from GaussLegendre::MIN_POINTS points each node
+ * and weight is found in O(1) by GaussLegendre::node(), instead of by GSL's Newton
+ * iteration on the O(n) recurrence, so the table takes O(n) rather than O(n^2)
+ * time and is divided among the threads.
+ * @param points the number of points
+ * @param num_threads the number of parallel threads to run
+ * @return the table, freed with gsl_integration_glfixed_table_free
+ */
+gsl_integration_glfixed_table *glfixedTableAlloc(int points, int num_threads) {
+	if (points < GaussLegendre::MIN_POINTS)
+		return gsl_integration_glfixed_table_alloc(points);
+	gsl_integration_glfixed_table *table =
+	      (gsl_integration_glfixed_table *) malloc(
+	            sizeof(gsl_integration_glfixed_table));
+	long m = (points + 1) / 2;
+	table->n = points;
+	table->x = (double *) malloc(m * sizeof(double));
+	table->w = (double *) malloc(m * sizeof(double));
+	table->precomputed = 0; // so gsl frees x and w
+
+	auto fill = [&](long first, long last) {
+		for (long i = first; i < last; i++) { // the kth node from 1 is x[m-k]
+			GaussLegendre::node(points, m - i, &table->x[i], &table->w[i]);
+		}
+		if (first == 0 && points % 2)
+			table->x[0] = 0; // the middle node, exactly
+	};
+	if (num_threads > 1) {
+		ThreadPool::getInstance().run(num_threads, [&](int i) {
+			fill(m * i / num_threads, m * (i + 1) / num_threads);
+		});
+	} else {
+		fill(0, m);
+	}
+	return table;
+}
+
+/**
+ * Finds the Gauss-Legendre table for a number of points, creating it on first use.
+ * Tables are kept (and shared by every thread) until the program exits, so the
+ * nodes and weights are only computed once for each number of points, and a table
+ * already created is found under a shared lock.
+ * @param points the number of points
+ * @param num_threads the number of threads to create the table with
+ * @return the table, which must not be freed
+ */
+const gsl_integration_glfixed_table *glfixedTable(int points, int num_threads) {
+	struct tableFree {
+		void operator()(gsl_integration_glfixed_table *table) const {
+			gsl_integration_glfixed_table_free(table);
+		}
+	};
+	static std::shared_mutex tables_mutex;
+	static std::map<int,
+	      std::unique_ptr<gsl_integration_glfixed_table, tableFree>> tables;
+
+	{ // tables are never removed, so threads finding theirs can share the lock
+		std::shared_lock<std::shared_mutex> lock(tables_mutex);
+		auto found = tables.find(points);
+		if (found != tables.end())
+			return found->second.get();
+	}
+	std::unique_lock<std::shared_mutex> lock(tables_mutex);
+	auto &table = tables[points]; // another thread may have created it meanwhile
+	if (!table)
+		table.reset(glfixedTableAlloc(points, num_threads));
+	return table.get();
+}
+
+/**
+ * Finds this thread's GSL workspace, with room for at least max_subdivisions intervals.
+ * Each thread keeps one workspace, sized to the largest request it has seen, and
+ * reuses it for every adaptive integral instead of allocating one per call.
+ * @param max_subdivisions the number of intervals needed
+ * @return the workspace, which must not be freed
+ */
+gsl_integration_workspace *pooledWorkspace(int max_subdivisions) {
+	struct workspaceFree {
+		void operator()(gsl_integration_workspace *workspace) const {
+			gsl_integration_workspace_free(workspace);
+		}
+	};
+	thread_local std::unique_ptr<gsl_integration_workspace, workspaceFree>
+	      workspace;
+
+	if (!workspace || workspace->limit < (size_t) max_subdivisions)
+		workspace.reset(gsl_integration_workspace_alloc(max_subdivisions));
+	return workspace.get();
+}
+
 /**
  * Calculates the numerical integral using a Guass-Legendre Rule with a fixed number of points.
  * @ingroup AdvancedRules
@@ -16,56 +109,331 @@ namespace AdvancedRules {
  * @return the numerically integrated value
  */
 double gaussLegendreFixed(gsl_function f, double a, double b, int points) {
-	gsl_integration_glfixed_table table;
-	table = *gsl_integration_glfixed_table_alloc(points);
-	return gsl_integration_glfixed(&f, a, b, &table);
+	return gsl_integration_glfixed(&f, a, b, glfixedTable(points));
 }
 
 /**
- * For threading -- calculates a section of the integral using a Guass-Legendre
- * Rule with a fixed number of points.
+ * Calculates the numerical integral using the nested Clenshaw-Curtis rule.
+ * The number of points doubles, reusing every earlier value, until the error
+ * estimate from the Chebyshev coefficients meets the error goal.
+ * @param [out] error_code pointer to store an error
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal
+ * @param max_points the most points to use
+ * @param [out] abserror the estimated error achieved
+ * @param [out] evaluations the number of function evaluations made (may be NULL)
+ * @return the numerically integrated value
+ */
+double clenshawCurtis(const char **error_code, const batchFunction &f,
+      double a, double b, double error, int max_points, double *abserror,
+      int *evaluations) {
+	int points;
+	double result = ClenshawCurtis::integrate(f, a, b, error, max_points - 1,
+	      abserror, &points);
+	if ((*abserror) > std::max(error, error * fabs(result)))
+		(*error_code) = gsl_strerror(GSL_EMAXITER);
+	if (evaluations)
+		(*evaluations) = points;
+	return result;
+}
+
+/**
+ * For threading -- calculates a section of the integral using a composite
+ * Guass-Legendre Rule with a fixed number of points in each panel.
  * @param f	the function to integrate
- * @param a the left (starting) point of the integral section
- * @param b the right (ending) point of the integral section
- * @param points the number of points
- * @param result_mutex pointer to a mutex for writing to the result
- * @param [out] result the sum of the numerical integral sections
+ * @param a the left (starting) point of the integral
+ * @param width the size of each panel
+ * @param first the first panel of this thread's section
+ * @param last one past the last panel of this thread's section
+ * @param table the Gauss-Legendre table for each panel
+ * @param [out] partial this thread's sum of the numerical integral sections
  */
-void gaussLegendreFixedThread(gsl_function f, double a, double b, int points,
-      std::mutex *result_mutex, double *result) {
-	gsl_integration_glfixed_table table;
-	table = *gsl_integration_glfixed_table_alloc(points);
-	double integrate = gsl_integration_glfixed(&f, a, b, &table);
-	result_mutex->lock();
-	(*result) += integrate;
-	result_mutex->unlock();
+void gaussLegendreFixedThread(gsl_function f, double a, double width,
+      long first, long last, const gsl_integration_glfixed_table *table,
+      partialSum *partial) {
+	for (long j = first; j < last; j++) {
+		partial->value += gsl_integration_glfixed(&f, a + j * width,
+		      a + (j + 1) * width, table);
+	}
+	partial->evaluations = table->n * (last - first);
 }
 
 /**
- * Calculates using parallel sections the numerical integral using a Guass-Legendre Rule with
- * a fixed number of points.
+ * Calculates using parallel sections the numerical integral using a composite
+ * Guass-Legendre Rule with a fixed number of points in each panel.
+ * The integral is divided into num_threads * panels_per_thread equal panels, and
+ * each thread integrates a contiguous run of them.
  * @param f the function to integrate
  * @param a the left (starting) point of the integral
  * @param b the right (ending) point of the integral
- * @param points the number of points
+ * @param points the number of points in each panel
  * @param num_threads the number of parallel threads to run
+ * @param panels_per_thread the number of panels for each thread
  * @return the numerically integrated value
  */
 double gaussLegendreFixedParallel(gsl_function f, double a, double b,
-      int points, int num_threads) {
-	std::thread threads[num_threads];
-	std::mutex result_mutex;
+      int points, int num_threads, int panels_per_thread) {
+	std::vector<partialSum> partials(num_threads);
+	const gsl_integration_glfixed_table *table = glfixedTable(points,
+	      num_threads);
+	long panels = (long) num_threads * panels_per_thread;
+	double width = (b - a) / panels;
+
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		gaussLegendreFixedThread(f, a, width, panels * i / num_threads,
+		      panels * (i + 1) / num_threads, table, &partials[i]);
+	});
+	return sumPartials(partials).value;
+}
+
+/**
+ * Calculates the numerical integral using a composite Gauss-Kronrod Rule, without GSL.
+ * Each panel uses the same nodes, weights and error estimate as gsl_integration_qk,
+ * with all of its points evaluated in one call of the function.
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param key the "key" for the GSL Gauss-Kronrod Rule
+ * @param panels the number of equal panels
+ * @param [out] abserror the sum of the panels' estimated errors
+ * @return the numerically integrated value
+ */
+double gaussKronrodFixed(const batchFunction &f, double a, double b, int key,
+      int panels, double *abserror) {
+	double width = (b - a) / panels;
 	double result = 0;
-	double width = b - a;
+	(*abserror) = 0;
+	for (int j = 0; j < panels; j++) {
+		GaussKronrod::panelResult panel = GaussKronrod::panel(f, a + j * width,
+		      j == panels - 1 ? b : a + (j + 1) * width, key);
+		result += panel.result;
+		(*abserror) += panel.abserr;
+	}
+	return result;
+}
 
-	for (int i = 0; i < num_threads; i++) {
-		threads[i] = std::thread(gaussLegendreFixedThread, f,
-		      a + (i * 0.25 * width), a + ((i + 1) * 0.25 * width), points,
-		      &result_mutex, &result);
+/**
+ * An interval of the globally adaptive Gauss-Kronrod rule, with its integral
+ */
+struct gkInterval {
+	double a; //!<the left (starting) point of the interval
+	double b; //!<the right (ending) point of the interval
+	double result; //!<the integral of the interval
+	double error; //!<the estimated error of result
+	int level; //!<the number of bisections from the whole integral
+	/**
+	 * Orders intervals by error, so the heap's top is the worst interval
+	 * @param other the interval to compare with
+	 * @return true if this interval has the smaller error
+	 */
+	bool operator<(const gkInterval &other) const {
+		return error < other.error;
 	}
-	for (int i = 0; i < num_threads; i++) {
-		threads[i].join();
+};
+
+/**
+ * Integrates an interval with the Gauss-Kronrod rule of a key
+ * @param f the function to integrate
+ * @param a the left (starting) point of the interval
+ * @param b the right (ending) point of the interval
+ * @param key the "key" for the GSL Gauss-Kronrod Rule
+ * @param level the number of bisections from the whole integral
+ * @return the interval
+ */
+gkInterval gkIntegrate(const batchFunction &f, double a, double b, int key,
+      int level) {
+	GaussKronrod::panelResult panel = GaussKronrod::panel(f, a, b, key);
+	if (!(fabs(panel.result) <= DBL_MAX) || !(panel.abserr <= DBL_MAX))
+		panel.abserr = DBL_MAX; // a singularity at a node: divide this interval first
+	return {a, b, panel.result, panel.abserr, level};
+}
+
+/**
+ * Calculates using parallel threads the numerical integral using a globally
+ * adaptive Gauss-Kronrod Rule with one error budget for the whole integral.
+ * Every round takes the intervals with the largest errors from a shared heap
+ * (one for each thread, then more while the budget needs them, up to
+ * GK_BATCH_PER_THREAD for each thread), the threads bisect them together, and
+ * the halves return to the heap.
+ * Threads write only their own halves, so they never wait on a lock.
+ * If extrapolate, the results are extrapolated level by level, as in QAGS: the
+ * intervals of the deepest level are set aside while the wider ones are bisected,
+ * and once the wider ones meet the budget, the total is the next term of Wynn's
+ * epsilon table and the level deepens. Each term then divides the function in the
+ * same way, deeper each time, so the sequence converges regularly. The limit is
+ * only used if it is closer to the total than the total's own error.
+ * @param [out] error_code pointer to store an error
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal (absolute, or relative to the result)
+ * @param max_subdivisions the maximum subdivisions to use
+ * @param key the "key" for the GSL Gauss-Kronrod Rule
+ * @param num_threads the number of parallel threads to run
+ * @param extrapolate whether to extrapolate the results level by level (with Wynn's
+ * epsilon algorithm)
+ * @param [out] abserror the estimated error achieved
+ * @param [out] subdivisions the number of subdivisions used (may be NULL)
+ * @return the numerically integrated value
+ */
+double globalGaussKronrod(const char **error_code, const batchFunction &f,
+      double a, double b, double error, int max_subdivisions, int key,
+      int num_threads, bool extrapolate, double *abserror, int *subdivisions) {
+	std::vector<gkInterval> intervals; // a heap, worst first
+	gkInterval whole = gkIntegrate(f, a, b, key, 0);
+	intervals.push_back(whole);
+	double min_width = fabs(b - a) * DBL_EPSILON; // narrower intervals are not divided
+	double total = whole.result;
+	double total_error = whole.error;
+	double narrow = 0; // the intervals too narrow to divide
+	double narrow_error = 0;
+	int subdivided = 1;
+
+	Extrapolation::wynnEpsilon epsilon;
+	double extrapolated = 0;
+	double extrapolated_error = DBL_MAX;
+	// with extrapolate, the intervals of level or deeper wait for the next term
+	int level = extrapolate ? 1 : INT_MAX;
+	std::vector<gkInterval> deep; // those taken from the heap
+	double wide_error = whole.error; // the error of the wider intervals
+	long wide = 1; // the number of wider intervals
+	bool refined = false; // whether any interval was bisected since the last term
+	// sums the wider intervals afresh, once the level or the totals change
+	auto countWide = [&]() {
+		wide_error = 0;
+		wide = 0;
+		for (const gkInterval &interval : intervals) {
+			if (interval.level < level) {
+				wide_error += interval.error;
+				wide++;
+			}
+		}
+	};
+
+	std::vector<gkInterval> batch;
+	std::vector<gkInterval> halves;
+	while (subdivided < max_subdivisions) {
+		double tolerance = std::max(error, error * fabs(total));
+		if (std::min(total_error, extrapolated_error) <= tolerance)
+			break;
+		if (wide_error <= tolerance) {
+			if (wide == (long) (intervals.size() + deep.size())) {
+				// only the intervals too narrow to divide miss the budget
+				(*error_code) = gsl_strerror(GSL_ESING);
+				break;
+			}
+			// the wider intervals meet the budget, so the total is the next term
+			double limit, limit_error;
+			if (refined && epsilon.add(total, &limit, &limit_error)
+			      && limit_error < extrapolated_error
+			      && fabs(limit - total) <= total_error) {
+				extrapolated = limit;
+				extrapolated_error = limit_error;
+			}
+			refined = false;
+			for (const gkInterval &interval : deep) {
+				intervals.push_back(interval);
+				std::push_heap(intervals.begin(), intervals.end());
+			}
+			deep.clear();
+			level++;
+			countWide();
+			continue;
+		}
+		// the worst intervals: one for each thread, and then more until removing
+		// their error would meet the budget (so one interval with most of the
+		// error does not leave the other threads idle)
+		batch.clear();
+		double batch_error = 0;
+		while (!intervals.empty()
+		      && (int) batch.size() < num_threads * GK_BATCH_PER_THREAD
+		      && subdivided + (int) batch.size() < max_subdivisions
+		      && ((int) batch.size() < num_threads
+		            || wide_error - batch_error > tolerance)) {
+			std::pop_heap(intervals.begin(), intervals.end());
+			gkInterval worst = intervals.back();
+			intervals.pop_back();
+			if (worst.level >= level) {
+				deep.push_back(worst);
+				continue;
+			}
+			if (worst.b - worst.a < min_width) {
+				narrow += worst.result;
+				narrow_error += worst.error;
+				wide_error -= worst.error;
+				wide--;
+				continue;
+			}
+			batch.push_back(worst);
+			batch_error += worst.error;
+		}
+		if (batch.empty())
+			break;
+
+		halves.resize(2 * batch.size());
+		int count = batch.size();
+		ThreadPool::getInstance().run(std::min(num_threads, count), [&](int i) {
+			for (int j = i; j < count; j += num_threads) {
+				double mid = 0.5 * (batch[j].a + batch[j].b);
+				halves[2 * j] = gkIntegrate(f, batch[j].a, mid, key,
+				      batch[j].level + 1);
+				halves[2 * j + 1] = gkIntegrate(f, mid, batch[j].b, key,
+				      batch[j].level + 1);
+			}
+		});
+
+		bool recount = false; // whether a value was not finite, spoiling the totals
+		for (int j = 0; j < count; j++) {
+			total += halves[2 * j].result + halves[2 * j + 1].result
+			      - batch[j].result;
+			total_error += halves[2 * j].error + halves[2 * j + 1].error
+			      - batch[j].error;
+			wide_error -= batch[j].error;
+			wide--;
+			recount |= batch[j].error == DBL_MAX;
+			for (int k = 2 * j; k <= 2 * j + 1; k++) {
+				if (halves[k].level < level) {
+					wide_error += halves[k].error;
+					wide++;
+				}
+				intervals.push_back(halves[k]);
+				std::push_heap(intervals.begin(), intervals.end());
+			}
+		}
+		subdivided += count;
+		refined = true;
+		if (recount) {
+			total = narrow;
+			total_error = narrow_error;
+			for (const std::vector<gkInterval> *heap : { &intervals, &deep }) {
+				for (const gkInterval &interval : *heap) {
+					total += interval.result;
+					total_error += interval.error;
+				}
+			}
+			countWide();
+		}
 	}
+	if (subdivided >= max_subdivisions)
+		(*error_code) = gsl_strerror(GSL_EMAXITER);
+	if (subdivisions)
+		(*subdivisions) = subdivided;
+
+	double result = narrow; // sum afresh, rather than trusting the running total
+	double result_error = narrow_error;
+	for (const std::vector<gkInterval> *heap : { &intervals, &deep }) {
+		for (const gkInterval &interval : *heap) {
+			result += interval.result;
+			result_error += interval.error;
+		}
+	}
+	if (extrapolated_error < result_error) {
+		(*abserror) = extrapolated_error;
+		return extrapolated;
+	}
+	(*abserror) = result_error;
 	return result;
 }
 
@@ -79,17 +447,32 @@ double gaussLegendreFixedParallel(gsl_function f, double a, double b,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double nonAdaptiveGaussKronrod(const char * error_code, gsl_function f,
+double nonAdaptiveGaussKronrod(const char **error_code, gsl_function f,
       double a, double b, double error, double *abserror) {
 	double result;
 	size_t evals;
 	int status = gsl_integration_qng(&f, a, b, error, error, &result, abserror,
 	      &evals);
 	if (status)
-		error_code = gsl_strerror(status);
+		(*error_code) = gsl_strerror(status);
 	return result;
 }
 
+/**
+ * Passes on the first error of the threads' own error codes
+ * @param error_codes the error code of each thread ("" for none)
+ * @param [out] error_code pointer to store an error (unchanged if there was none)
+ */
+void firstError(const std::vector<const char*> &error_codes,
+      const char **error_code) {
+	for (const char *code : error_codes) {
+		if (code[0] != '\0') {
+			(*error_code) = code;
+			return;
+		}
+	}
+}
+
 /**
  * For threading -- calculates a section of the integral using a Non-Adaptive Guass-Kronrod
  * Rule with an error bound
@@ -98,29 +481,27 @@ double nonAdaptiveGaussKronrod(const char * error_code, gsl_function f,
  * @param a the left (starting) point of the integral
  * @param b the right (ending) point of the integral
  * @param error the error goal
- * @param [out] abserror the maximum error achieved
- * @param result_mutex pointer to a mutex for writing to the result
- * @param [out] result the sum of the numerical integral sections
+ * @param [out] partial this thread's sum of the numerical integral sections
  */
-void nonAdaptiveGaussKronrodThread(const char * error_code, gsl_function f,
-      double a, double b, double error, std::mutex*result_mutex, double *result,
-      double *abserror) {
+void nonAdaptiveGaussKronrodThread(const char **error_code, gsl_function f,
+      double a, double b, double error, partialSum *partial) {
 	double integrate;
 	double errorabs;
 	size_t evals;
 	int status = gsl_integration_qng(&f, a, b, error, error, &integrate,
 	      &errorabs, &evals);
-	result_mutex->lock();
 	if (status)
-		error_code = gsl_strerror(status);
-	(*result) += integrate;
-	(*abserror) += pow(errorabs, 2);
-	result_mutex->unlock();
+		(*error_code) = gsl_strerror(status);
+	partial->value = integrate;
+	partial->error = pow(errorabs, 2);
+	partial->evaluations = evals;
 }
 
 /**
  * Calculates using parallel sections the numerical integral using a Guass-Kronrod Rule
- * with an error bound
+ * with an error bound. Each thread integrates one of num_threads equal pieces (the
+ * rule's cost barely depends on the function, so balancedPartition()'s pilot would
+ * cost more than it saves).
  * @param [out] error_code pointer to store an error
  * @param f the function to integrate
  * @param a the left (starting) point of the integral
@@ -130,23 +511,20 @@ void nonAdaptiveGaussKronrodThread(const char * error_code, gsl_function f,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double nonAdaptiveGaussKronrodParallel(const char * error_code, gsl_function f,
+double nonAdaptiveGaussKronrodParallel(const char **error_code, gsl_function f,
       double a, double b, double error, int num_threads, double *abserror) {
-	std::thread threads[num_threads];
-	std::mutex result_mutex;
-	double result = 0;
-	double width = b - a;
+	std::vector<partialSum> partials(num_threads);
+	std::vector<const char*> error_codes(num_threads, ""); // one for each thread
+	double width = (b - a) / num_threads;
 
-	for (int i = 0; i < num_threads; i++) {
-		threads[i] = std::thread(nonAdaptiveGaussKronrodThread, error_code, f,
-		      a + (i * 0.25 * width), a + ((i + 1) * 0.25 * width), error,
-		      &result_mutex, &result, abserror);
-	}
-	for (int i = 0; i < num_threads; i++) {
-		threads[i].join();
-	}
-	(*abserror) = sqrt(*abserror);
-	return result;
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		nonAdaptiveGaussKronrodThread(&error_codes[i], f, a + i * width,
+		      i + 1 == num_threads ? b : a + (i + 1) * width, error, &partials[i]);
+	});
+	firstError(error_codes, error_code);
+	partialSum total = sumPartials(partials);
+	(*abserror) = sqrt(total.error);
+	return total.value;
 }
 /**
  * Calculates the numerical integral using an adaptive Guass-Kronrod Rule
@@ -161,53 +539,22 @@ double nonAdaptiveGaussKronrodParallel(const char * error_code, gsl_function f,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double adaptiveGaussKronrod(const char * error_code, gsl_function f, double a,
+double adaptiveGaussKronrod(const char **error_code, gsl_function f, double a,
       double b, double error, int max_subdivisions, int key, double *abserror) {
 
-	gsl_integration_workspace * workspace = gsl_integration_workspace_alloc(
-	      (unsigned long int) max_subdivisions);
+	gsl_integration_workspace * workspace = pooledWorkspace(max_subdivisions);
 	double result;
 	int status = gsl_integration_qag(&f, a, b, error, error,
 	      (size_t) max_subdivisions, key, workspace, &result, abserror);
 	if (status)
-		error_code = gsl_strerror(status);
-	gsl_integration_workspace_free(workspace);
+		(*error_code) = gsl_strerror(status);
 	return result;
 }
 /**
- * For threading -- calculates a section of the integral using an adaptive Guass-Kronrod Rule
- * with an error bound and specified key
- * @param [out] error_code pointer to store an error
- * @param f the function to integrate
- * @param a the left (starting) point of the integral
- * @param b the right (ending) point of the integral
- * @param error the error goal
- * @param max_subdivisions the maximum subdivisions to use
- * @param key the "key" for the GSL Gauss-Kronrod Rule
- * @param result_mutex pointer to a mutex for writing to the result
- * @param [out] result the sum of the numerical integral sections
- * @param [out] abserror the maximum error achieved
- */
-void adaptiveGaussKronrodThread(const char * error_code, gsl_function f,
-      double a, double b, double error, int max_subdivisions, int key,
-      std::mutex*result_mutex, double *result, double *abserror) {
-	gsl_integration_workspace * workspace = gsl_integration_workspace_alloc(
-	      (unsigned long int) max_subdivisions);
-	double integrate;
-	double errorabs;
-	int status = gsl_integration_qag(&f, a, b, error, error,
-	      (size_t) max_subdivisions, key, workspace, &integrate, &errorabs);
-	result_mutex->lock();
-	if (status)
-		error_code = gsl_strerror(status);
-	(*result) += integrate;
-	(*abserror) += pow(errorabs, 2);
-	result_mutex->unlock();
-	gsl_integration_workspace_free(workspace);
-}
-/**
- * Calculates using parallel sections the numerical integral using an adaptive
- * Guass-Kronrod Rule with an error bound.
+ * Calculates using parallel threads the numerical integral using a globally
+ * adaptive Guass-Kronrod Rule with an error bound.
+ * The intervals are shared by every thread, with one error budget for the whole
+ * integral, and the worst are bisected in parallel batches (see globalGaussKronrod()).
  * @param [out] error_code pointer to store an error
  * @param f the function to integrate
  * @param a the left (starting) point of the integral
@@ -219,25 +566,11 @@ void adaptiveGaussKronrodThread(const char * error_code, gsl_function f,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double adaptiveGaussKronrodParallel(const char * error_code, gsl_function f,
-      double a, double b, double error, int max_subdivisions, int key,
-      int num_threads, double *abserror) {
-	std::thread threads[num_threads];
-	std::mutex result_mutex;
-	double result = 0;
-	double width = b - a;
-
-	for (int i = 0; i < num_threads; i++) {
-		threads[i] = std::thread(adaptiveGaussKronrodThread, error_code, f,
-		      a + (i * 0.25 * width), a + ((i + 1) * 0.25 * width), error,
-		      (max_subdivisions / num_threads), key, &result_mutex, &result,
-		      abserror);
-	}
-	for (int i = 0; i < num_threads; i++) {
-		threads[i].join();
-	}
-	(*abserror) = sqrt(*abserror);
-	return result;
+double adaptiveGaussKronrodParallel(const char **error_code,
+      const batchFunction &f, double a, double b, double error,
+      int max_subdivisions, int key, int num_threads, double *abserror) {
+	return globalGaussKronrod(error_code, f, a, b, error, max_subdivisions, key,
+	      num_threads, false, abserror);
 }
 /**
  * Calculates nthe numerical integral using an adaptive Guass-Kronrod Rule
@@ -251,52 +584,22 @@ double adaptiveGaussKronrodParallel(const char * error_code, gsl_function f,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double adaptiveGaussKronrodSingular(const char * error_code, gsl_function f,
+double adaptiveGaussKronrodSingular(const char **error_code, gsl_function f,
       double a, double b, double error, int max_subdivisions,
       double *abserror) {
-	gsl_integration_workspace * workspace = gsl_integration_workspace_alloc(
-	      (unsigned long int) max_subdivisions);
+	gsl_integration_workspace * workspace = pooledWorkspace(max_subdivisions);
 	double result;
 	int status = gsl_integration_qags(&f, a, b, error, error,
 	      (size_t) max_subdivisions, workspace, &result, abserror);
 	if (status)
-		error_code = gsl_strerror(status);
-	gsl_integration_workspace_free(workspace);
+		(*error_code) = gsl_strerror(status);
 	return result;
 }
 /**
- * For threading -- calculates a section of the integral using an adaptive
- * Guass-Kronrod Rule with an error bound, for functions with singularities.
- * @param [out] error_code pointer to store an error
- * @param f the function to integrate
- * @param a the left (starting) point of the integral
- * @param b the right (ending) point of the integral
- * @param error the error goal
- * @param max_subdivisions the maximum subdivisions to use
- * @param result_mutex pointer to a mutex for writing to the result
- * @param [out] result the sum of the numerical integral sections
- * @param [out] abserror the maximum error achieved
- */
-void adaptiveGaussKronrodSingularThread(const char * error_code, gsl_function f,
-      double a, double b, double error, int max_subdivisions,
-      std::mutex*result_mutex, double *result, double *abserror) {
-	gsl_integration_workspace * workspace = gsl_integration_workspace_alloc(
-	      (unsigned long int) max_subdivisions);
-	double integrate;
-	double errorabs;
-	int status = gsl_integration_qags(&f, a, b, error, error,
-	      (size_t) max_subdivisions, workspace, &integrate, &errorabs);
-	result_mutex->lock();
-	if (status)
-		error_code = gsl_strerror(status);
-	(*result) += integrate;
-	(*abserror) += pow(errorabs, 2);
-	result_mutex->unlock();
-	gsl_integration_workspace_free(workspace);
-}
-/**
- * Calculates using parallel sections the numerical integral using using an adaptive
- * Guass-Kronrod Rule with an error bound, for functions with singularities.
+ * Calculates using parallel threads the numerical integral using a globally
+ * adaptive Guass-Kronrod Rule with an error bound, for functions with singularities.
+ * As in QAGS, the 21 point rule is used and the sequence of results is extrapolated
+ * with Wynn's epsilon algorithm.
  * @param [out] error_code pointer to store an error
  * @param f the function to integrate
  * @param a the left (starting) point of the integral
@@ -307,24 +610,11 @@ void adaptiveGaussKronrodSingularThread(const char * error_code, gsl_function f,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double adaptiveGaussKronrodSingularParallel(const char * error_code,
-      gsl_function f, double a, double b, double error, int max_subdivisions,
-      int num_threads, double *abserror) {
-	std::thread threads[num_threads];
-	std::mutex result_mutex;
-	double result = 0;
-	double width = b - a;
-
-	for (int i = 0; i < num_threads; i++) {
-		threads[i] = std::thread(adaptiveGaussKronrodSingularThread, error_code,
-		      f, a + (i * 0.25 * width), a + ((i + 1) * 0.25 * width), error,
-		      (max_subdivisions / num_threads), &result_mutex, &result, abserror);
-	}
-	for (int i = 0; i < num_threads; i++) {
-		threads[i].join();
-	}
-	(*abserror) = sqrt(*abserror);
-	return result;
+double adaptiveGaussKronrodSingularParallel(const char **error_code,
+      const batchFunction &f, double a, double b, double error,
+      int max_subdivisions, int num_threads, double *abserror) {
+	return globalGaussKronrod(error_code, f, a, b, error, max_subdivisions,
+	      GSL_INTEG_GAUSS21, num_threads, true, abserror);
 }
 /**
  * Calculates the numerical integral using an adaptive Guass-Kronrod Rule
@@ -339,11 +629,10 @@ double adaptiveGaussKronrodSingularParallel(const char * error_code,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double adaptiveGaussKronrodKnownSingular(const char * error_code,
+double adaptiveGaussKronrodKnownSingular(const char **error_code,
       gsl_function f, double a, double b, double error, int max_subdivisions,
       double singularity, double *abserror) {
-	gsl_integration_workspace * workspace = gsl_integration_workspace_alloc(
-	      (unsigned long int) max_subdivisions);
+	gsl_integration_workspace * workspace = pooledWorkspace(max_subdivisions);
 	std::vector<double> points;
 	points.push_back(a);
 	if (singularity != 0)
@@ -353,8 +642,7 @@ double adaptiveGaussKronrodKnownSingular(const char * error_code,
 	int status = gsl_integration_qagp(&f, points.data(), points.size(), error,
 	      error, (size_t) max_subdivisions, workspace, &result, abserror);
 	if (status)
-		error_code = gsl_strerror(status);
-	gsl_integration_workspace_free(workspace);
+		(*error_code) = gsl_strerror(status);
 	return result;
 }
 /**
@@ -367,31 +655,28 @@ double adaptiveGaussKronrodKnownSingular(const char * error_code,
  * @param error the error goal
  * @param max_subdivisions the maximum subdivisions to use
  * @param points the end-points and singularities of the region
- * @param result_mutex pointer to a mutex for writing to the result
- * @param [out] result the sum of the numerical integral sections
- * @param [out] abserror the maximum error achieved
+ * @param [out] partial this thread's sum of the numerical integral sections
  */
-void adaptiveGaussKronrodKnownSingularThread(const char * error_code,
+void adaptiveGaussKronrodKnownSingularThread(const char **error_code,
       gsl_function f, double a, double b, double error, int max_subdivisions,
-      std::vector<double> points, std::mutex*result_mutex, double *result,
-      double *abserror) {
-	gsl_integration_workspace * workspace = gsl_integration_workspace_alloc(
-	      (unsigned long int) max_subdivisions);
+      std::vector<double> points, partialSum *partial) {
+	gsl_integration_workspace * workspace = pooledWorkspace(max_subdivisions);
 	double integrate;
 	double errorabs;
 	int status = gsl_integration_qagp(&f, points.data(), points.size(), error,
 	      error, (size_t) max_subdivisions, workspace, &integrate, &errorabs);
-	result_mutex->lock();
 	if (status)
-		error_code = gsl_strerror(status);
-	(*result) += integrate;
-	(*abserror) += pow(errorabs, 2);
-	result_mutex->unlock();
-	gsl_integration_workspace_free(workspace);
+		(*error_code) = gsl_strerror(status);
+	partial->value = integrate;
+	partial->error = pow(errorabs, 2);
+	// 21 point rule, each bisection evaluating both halves
+	partial->evaluations = (2 * workspace->size - 1) * 21;
 }
 /**
  * Calculates using parallel sections the numerical integral using using an adaptive
  * Guass-Kronrod Rule with an error bound, for functions with a known singularity.
+ * Each thread integrates one piece of balancedPartition(), and the pilot's
+ * evaluations are counted with the pieces'.
  * @param [out] error_code pointer to store an error
  * @param f the function to integrate
  * @param a the left (starting) point of the integral
@@ -403,29 +688,163 @@ void adaptiveGaussKronrodKnownSingularThread(const char * error_code,
  * @param [out] abserror the maximum error achieved
  * @return the numerically integrated value
  */
-double adaptiveGaussKronrodKnownSingularParallel(const char * error_code,
+double adaptiveGaussKronrodKnownSingularParallel(const char **error_code,
       gsl_function f, double a, double b, double error, int max_subdivisions,
       double singularity, int num_threads, double *abserror) {
-	std::thread threads[num_threads];
-	std::mutex result_mutex;
-	double result = 0;
-	double width = b - a;
-	for (int i = 0; i < num_threads; i++) {
-		double aNew = a + (i * 0.25 * width);
-		double bNew = a + (i * 0.25 * width);
+	long pilot_evaluations;
+	std::vector<double> pieces = balancedPartition(batchFunction(f), a, b,
+	      num_threads, &pilot_evaluations);
+	num_threads = pieces.size() - 1;
+	std::vector<partialSum> partials(num_threads);
+	std::vector<const char*> error_codes(num_threads, ""); // one for each thread
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		double aNew = pieces[i];
+		double bNew = pieces[i + 1];
 		std::vector<double> subPoints;
 		subPoints.push_back(aNew);
 		if (singularity != 0 && singularity > aNew && singularity < bNew)
 			subPoints.push_back(singularity);
 		subPoints.push_back(bNew);
-		threads[i] = std::thread(adaptiveGaussKronrodKnownSingularThread,
-		      error_code, f, aNew, bNew, error, (max_subdivisions / num_threads),
-		      subPoints, &result_mutex, &result, abserror);
-	}
-	for (int i = 0; i < num_threads; i++) {
-		threads[i].join();
-	}
-	(*abserror) = sqrt(*abserror);
+		adaptiveGaussKronrodKnownSingularThread(&error_codes[i], f, aNew, bNew,
+		      error, (max_subdivisions / num_threads), subPoints, &partials[i]);
+	});
+	firstError(error_codes, error_code);
+	partialSum total = sumPartials(partials);
+	total.evaluations += pilot_evaluations;
+	(*abserror) = sqrt(total.error);
+	return total.value;
+}
+
+/**
+ * Calculates the numerical integral using the tanh-sinh (double exponential) rule,
+ * for functions with singularities at the ends.
+ * Levels are added until the change from the last level meets the error goal.
+ * @param [out] error_code pointer to store an error
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal
+ * @param max_levels the most levels to use (each halves the step)
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+double tanhSinh(const char **error_code, const batchFunction &f, double a,
+      double b, double error, int max_levels, double *abserror) {
+	int levels;
+	double result = TanhSinh::integrate(f, a, b, error, max_levels, 1, abserror,
+	      &levels);
+	if ((*abserror) > std::max(error, error * fabs(result)))
+		(*error_code) = gsl_strerror(GSL_EMAXITER);
+	return result;
+}
+/**
+ * Calculates using parallel threads the numerical integral using the tanh-sinh
+ * (double exponential) rule, for functions with singularities at the ends.
+ * The points of each level are divided among the threads.
+ * @param [out] error_code pointer to store an error
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal
+ * @param max_levels the most levels to use (each halves the step)
+ * @param num_threads the number of parallel threads to run
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+double tanhSinhParallel(const char **error_code, const batchFunction &f,
+      double a, double b, double error, int max_levels, int num_threads,
+      double *abserror) {
+	int levels;
+	double result = TanhSinh::integrate(f, a, b, error, max_levels, num_threads,
+	      abserror, &levels);
+	if ((*abserror) > std::max(error, error * fabs(result)))
+		(*error_code) = gsl_strerror(GSL_EMAXITER);
 	return result;
 }
+
+/**
+ * Calculates the numerical integral using the adaptive Gauss-Lobatto rule.
+ * Each interval which misses the error goal is divided in six at its rule's points,
+ * so its subintervals reuse the values at their ends.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal (absolute, or relative to the integral)
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+double adaptiveGaussLobatto(const batchFunction &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions) {
+	return GaussLobatto::adaptiveNonParallel<deferredRepair>(f, a, b, error,
+	      max_subdivisions, max_time, subdivisions);
+}
+/**
+ * Calculates using parallel threads the numerical integral using the adaptive
+ * Gauss-Lobatto rule.
+ * The threads start from the intervals of balancedPartition()'s pilot which miss
+ * the error goal (see pilotStarts()), each taking a run of neighbours, and idle
+ * threads steal intervals from the others.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal (absolute, or relative to the integral)
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+double adaptiveGaussLobattoParallel(const batchFunction &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      int *subdivisions, double *utilization) {
+	return GaussLobatto::adaptiveParallel<deferredRepair>(f, a, b, num_threads,
+	      error, max_subdivisions, max_time, subdivisions, utilization);
+}
+
+/**
+ * Calculates the numerical integral using the hp-adaptive Newton-Cotes rule.
+ * Each interval raises its order while the function is smooth there, and is
+ * divided in two where it is not.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+double hpAdaptiveNewtonCotes(const batchFunction &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions) {
+	return HpAdaptive::adaptiveNonParallel<deferredRepair>(f, a, b, error,
+	      max_subdivisions, max_time, subdivisions);
+}
+/**
+ * Calculates using parallel threads the numerical integral using the hp-adaptive
+ * Newton-Cotes rule.
+ * The threads start from the intervals of balancedPartition()'s pilot which miss
+ * the error goal (see pilotStarts()), each taking a run of neighbours, and idle
+ * threads steal intervals from the others.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+double hpAdaptiveNewtonCotesParallel(const batchFunction &f, double a,
+      double b, int num_threads, double error, int max_subdivisions,
+      int max_time, int *subdivisions, double *utilization) {
+	return HpAdaptive::adaptiveParallel<deferredRepair>(f, a, b, num_threads,
+	      error, max_subdivisions, max_time, subdivisions, utilization);
+}
 }
@@ -10,13 +10,29 @@
 #include <gsl/gsl_integration.h>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <climits>
+#include "../ThreadPool.h"
+#include "../PartialSum.h"
+#include "../Partition.h"
+#include "GaussKronrod.h"
+#include "Extrapolation.h"
+#include "TanhSinh.h"
+#include "ClenshawCurtis.h"
+#include "GaussLegendre.h"
+#include "GaussLobatto.h"
+#include "HpAdaptive.h"
 namespace AdvancedRules {
 /**
  * Allows for specification of which algorithm to call
  */
 enum algorithm {
 	a_gaussLegendreFixed,
+	a_clenshawCurtis,
 	a_nonAdaptiveGaussKronrod,
 
 	a_gaussLegendreFixedParallel,
@@ -30,34 +46,75 @@ enum algorithm {
 	a_adaptiveGaussKronrodSingularParallel,
 	a_adaptiveGaussKronrodKnownSingularParallel,
 
+	a_tanhSinh,
+	a_tanhSinhParallel,
+
 	size //!< provides the length of the enum (for looping)
 };
 
+/**
+ * The most intervals each thread bisects in one round of globalGaussKronrod()
+ */
+const int GK_BATCH_PER_THREAD = 4;
+
+gsl_integration_glfixed_table *glfixedTableAlloc(int points,
+      int num_threads = 1);
+const gsl_integration_glfixed_table *glfixedTable(int points,
+      int num_threads = 1);
+gsl_integration_workspace *pooledWorkspace(int max_subdivisions);
+
 double gaussLegendreFixed(gsl_function f, double a, double b, int points);
+double clenshawCurtis(const char **error_code, const batchFunction &f,
+      double a, double b, double error, int max_points, double *abserror,
+      int *evaluations = NULL);
 
 double gaussLegendreFixedParallel(gsl_function f, double a, double b,
-      int points, int num_threads);
+      int points, int num_threads, int panels_per_thread = 1);
+
+double gaussKronrodFixed(const batchFunction &f, double a, double b, int key,
+      int panels, double *abserror);
 
-double nonAdaptiveGaussKronrod(const char * error_code, gsl_function f,
+double nonAdaptiveGaussKronrod(const char **error_code, gsl_function f,
       double a, double b, double error, double *abserror);
-double nonAdaptiveGaussKronrodParallel(const char * error_code, gsl_function f,
+double nonAdaptiveGaussKronrodParallel(const char **error_code, gsl_function f,
       double a, double b, double error, int num_threads, double *abserror);
-double adaptiveGaussKronrod(const char * error_code, gsl_function f, double a,
+double adaptiveGaussKronrod(const char **error_code, gsl_function f, double a,
       double b, double error, int max_subdivisions, int key, double *abserror);
-double adaptiveGaussKronrodParallel(const char * error_code, gsl_function f,
-      double a, double b, double error, int max_subdivisions, int key,
-      int num_threads, double *abserror);
-double adaptiveGaussKronrodSingular(const char * error_code, gsl_function f,
+double adaptiveGaussKronrodParallel(const char **error_code,
+      const batchFunction &f, double a, double b, double error,
+      int max_subdivisions, int key, int num_threads, double *abserror);
+double adaptiveGaussKronrodSingular(const char **error_code, gsl_function f,
       double a, double b, double error, int max_subdivisions, double *abserror);
-double adaptiveGaussKronrodSingularParallel(const char * error_code,
-      gsl_function f, double a, double b, double error, int max_subdivisions,
-      int num_threads, double *abserror);
-double adaptiveGaussKronrodKnownSingular(const char * error_code,
+double adaptiveGaussKronrodSingularParallel(const char **error_code,
+      const batchFunction &f, double a, double b, double error,
+      int max_subdivisions, int num_threads, double *abserror);
+double globalGaussKronrod(const char **error_code, const batchFunction &f,
+      double a, double b, double error, int max_subdivisions, int key,
+      int num_threads, bool extrapolate, double *abserror,
+      int *subdivisions = NULL);
+double adaptiveGaussKronrodKnownSingular(const char **error_code,
       gsl_function f, double a, double b, double error, int max_subdivisions,
       double singularity, double *abserror);
-double adaptiveGaussKronrodKnownSingularParallel(const char * error_code,
+double adaptiveGaussKronrodKnownSingularParallel(const char **error_code,
       gsl_function f, double a, double b, double error, int max_subdivisions,
       double singularity, int num_threads, double *abserror);
+
+double tanhSinh(const char **error_code, const batchFunction &f, double a,
+      double b, double error, int max_levels, double *abserror);
+double tanhSinhParallel(const char **error_code, const batchFunction &f,
+      double a, double b, double error, int max_levels, int num_threads,
+      double *abserror);
+
+double adaptiveGaussLobatto(const batchFunction &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions);
+double adaptiveGaussLobattoParallel(const batchFunction &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      int *subdivisions, double *utilization = NULL);
+double hpAdaptiveNewtonCotes(const batchFunction &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions);
+double hpAdaptiveNewtonCotesParallel(const batchFunction &f, double a,
+      double b, int num_threads, double error, int max_subdivisions,
+      int max_time, int *subdivisions, double *utilization = NULL);
 }
 
 #endif /* ADVANCEDRULES_ADVANCEDRULES_H_ */
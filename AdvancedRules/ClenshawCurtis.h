@@ -0,0 +1,152 @@
+/**
+ * @file ClenshawCurtis.h
+ * @brief Contains the nested Clenshaw-Curtis rule, for smooth functions
+ * The function is interpolated at the Chebyshev points cos(j pi/N), its Chebyshev
+ * coefficients are found with a DCT (by FFT, in O(N log N)), and the interpolant is
+ * integrated exactly. Doubling N keeps every previous point, so each refinement
+ * only evaluates the N new ones, and the size of the last coefficients estimates
+ * the error.
+ * @author Irene Crowell
+ */
+#ifndef CLENSHAWCURTIS_H_
+#define CLENSHAWCURTIS_H_
+#include <math.h>
+#include <float.h>
+#include <complex>
+#include <vector>
+#include "../NewtonCotesRules/BatchFunction.h"
+
+namespace ClenshawCurtis {
+/**
+ * The fewest intervals (N) whose error estimate is trusted
+ */
+const int MIN_INTERVALS = 16;
+/**
+ * The number of intervals the rule starts with
+ */
+const int START_INTERVALS = 4;
+
+/**
+ * Transforms data in place with a radix-2 FFT (e^(-2 pi i jk/n) kernel)
+ * @param data the sequence, whose length must be a power of 2
+ */
+inline void fft(std::vector<std::complex<double>> &data) {
+	const size_t n = data.size();
+	for (size_t i = 1, j = 0; i < n; i++) { // bit reversal
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j)
+			std::swap(data[i], data[j]);
+	}
+	for (size_t length = 2; length <= n; length <<= 1) {
+		double angle = -2 * M_PI / length;
+		std::complex<double> step(cos(angle), sin(angle));
+		for (size_t i = 0; i < n; i += length) {
+			std::complex<double> w(1);
+			for (size_t k = 0; k < length / 2; k++) {
+				std::complex<double> even = data[i + k];
+				std::complex<double> odd = data[i + k + length / 2] * w;
+				data[i + k] = even + odd;
+				data[i + k + length / 2] = even - odd;
+				w *= step;
+			}
+		}
+	}
+}
+
+/**
+ * Finds the Chebyshev coefficients of the interpolant through values at the
+ * points cos(j pi/N), j = 0..N, using a DCT-I computed by an FFT of length 2N
+ * @param values the N+1 values, in order of j
+ * @return the N+1 coefficients (of T_0 to T_N)
+ */
+inline std::vector<double> chebyshevCoefficients(
+      const std::vector<double> &values) {
+	const size_t intervals = values.size() - 1;
+	std::vector<std::complex<double>> data(2 * intervals);
+	for (size_t j = 0; j <= intervals; j++) { // the even extension
+		data[j] = values[j];
+		if (j > 0 && j < intervals)
+			data[2 * intervals - j] = values[j];
+	}
+	fft(data);
+	std::vector<double> coefficients(intervals + 1);
+	for (size_t k = 0; k <= intervals; k++) {
+		coefficients[k] = data[k].real() / intervals;
+	}
+	coefficients[0] *= 0.5;
+	coefficients[intervals] *= 0.5;
+	return coefficients;
+}
+
+/**
+ * Calculates the numerical integral using the Clenshaw-Curtis rule, doubling the
+ * number of intervals until the error estimate meets the error goal.
+ * The error is estimated from the last four Chebyshev coefficients, which bound
+ * the part of the function the interpolant has not yet resolved.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal (absolute, or relative to the result)
+ * @param max_intervals the most intervals (N) to use
+ * @param [out] abserror the estimated error achieved
+ * @param [out] evaluations the number of function evaluations made
+ * @return the numerically integrated value
+ */
+template<typename Function>
+double integrate(const Function &f, double a, double b, double error,
+      int max_intervals, double *abserror, int *evaluations) {
+	const double center = 0.5 * (a + b);
+	const double half = 0.5 * (b - a);
+	int intervals = START_INTERVALS;
+	std::vector<double> x(intervals + 1);
+	std::vector<double> values(intervals + 1);
+	for (int j = 0; j <= intervals; j++) {
+		x[j] = center + half * cos(j * M_PI / intervals);
+	}
+	findVals(f, x.data(), values.data(), intervals + 1, half / intervals);
+
+	double result = 0;
+	while (true) {
+		std::vector<double> coefficients = chebyshevCoefficients(values);
+		result = 0;
+		for (int k = 0; k <= intervals; k += 2) {
+			result += coefficients[k] * 2 / (1 - (double) k * k);
+		}
+		result *= half;
+		double tail = 0;
+		for (int k = intervals - 3; k <= intervals; k++) {
+			tail += fabs(coefficients[k]);
+		}
+		(*abserror) = fabs(half) * tail;
+		if ((intervals >= MIN_INTERVALS
+		      && (*abserror) <= std::max(error, error * fabs(result)))
+		      || 2 * intervals > max_intervals)
+			break;
+
+		// the new points lie halfway (in angle) between the old ones
+		x.resize(intervals);
+		for (int i = 0; i < intervals; i++) {
+			x[i] = center + half * cos((2 * i + 1) * M_PI / (2 * intervals));
+		}
+		std::vector<double> fresh(intervals);
+		findVals(f, x.data(), fresh.data(), intervals, half / intervals);
+		std::vector<double> merged(2 * intervals + 1);
+		for (int j = 0; j <= intervals; j++) {
+			merged[2 * j] = values[j];
+		}
+		for (int i = 0; i < intervals; i++) {
+			merged[2 * i + 1] = fresh[i];
+		}
+		values.swap(merged);
+		intervals *= 2;
+	}
+	(*evaluations) = intervals + 1;
+	return result;
+}
+}
+
+#endif /* CLENSHAWCURTIS_H_ */
@@ -0,0 +1,144 @@
+/**
+ * @file Extrapolation.h
+ * @brief Contains Wynn's epsilon algorithm and Richardson extrapolation, for
+ * extrapolating a sequence of integrals
+ * Given the results of successive refinements of an integral, the epsilon table
+ * estimates the limit of the sequence, which converges much faster than the
+ * sequence itself when the refinement is slowed by a singularity (as in QAGS).
+ * Richardson's tableau (as in Romberg integration) instead removes the known
+ * powers of the width from a smooth function's composite rules.
+ * @author Irene Crowell
+ */
+#ifndef EXTRAPOLATION_H_
+#define EXTRAPOLATION_H_
+#include <math.h>
+#include <float.h>
+#include <vector>
+
+namespace Extrapolation {
+/**
+ * The most terms of the sequence the epsilon table uses (the latest are kept)
+ */
+const int EPSILON_TERMS = 50;
+
+/**
+ * Extrapolates the limit of a sequence with Wynn's epsilon algorithm.
+ * Each term is added with add(), which rebuilds the table from the latest terms
+ * and estimates the error of the extrapolation from the last three estimates.
+ */
+struct wynnEpsilon {
+	std::vector<double> terms; //!<the latest terms of the sequence, oldest first
+	double estimates[3] = { 0, 0, 0 }; //!<the last three extrapolations, latest first
+	int count = 0; //!<the number of extrapolations made
+
+	/**
+	 * Adds a term to the sequence and extrapolates its limit
+	 * @param term the next term of the sequence
+	 * @param [out] result the extrapolated limit
+	 * @param [out] abserror the estimated error of result
+	 * @return true if there were enough terms to extrapolate (and estimate the error)
+	 */
+	bool add(double term, double *result, double *abserror) {
+		terms.push_back(term);
+		if ((int) terms.size() > EPSILON_TERMS)
+			terms.erase(terms.begin());
+		int n = terms.size();
+		if (n < 3)
+			return false;
+
+		// column holds epsilon_k for each start j, and previous epsilon_(k-1)
+		std::vector<double> previous(n + 1, 0);
+		std::vector<double> column(terms);
+		double limit = terms[n - 1];
+		double limit_error = DBL_MAX;
+		double last_even = terms[n - 1]; // the latest estimate of the last even column
+		for (int k = 1; k < n; k++) {
+			std::vector<double> next(n - k);
+			bool converged = false;
+			for (int j = 0; j < n - k; j++) {
+				double difference = column[j + 1] - column[j];
+				if (fabs(difference) <= DBL_EPSILON * fabs(column[j + 1])) {
+					converged = true; // the column has converged, so the table ends
+					if ((k - 1) % 2 == 0) {
+						limit = column[j + 1];
+						limit_error = 0;
+					}
+					break;
+				}
+				next[j] = previous[j + 1] + 1 / difference;
+			}
+			if (converged)
+				break;
+			previous = column;
+			column = next;
+			if (k % 2 == 0) { // even columns estimate the limit
+				double change = fabs(column[n - k - 1] - last_even);
+				last_even = column[n - k - 1];
+				if (change < limit_error) {
+					limit = last_even;
+					limit_error = change;
+				}
+			}
+		}
+
+		estimates[2] = estimates[1];
+		estimates[1] = estimates[0];
+		estimates[0] = limit;
+		count++;
+		if (count < 3)
+			return false;
+		(*result) = limit;
+		(*abserror) = fabs(limit - estimates[1]) + fabs(limit - estimates[2])
+		      + 5 * DBL_EPSILON * fabs(limit);
+		return true;
+	}
+};
+
+/**
+ * Extrapolates the limit of a sequence of composite rules with Richardson's
+ * tableau, when each term multiplies the subdivisions of the last by the same
+ * ratio and the rule's error is a series in the width^order, width^(order+2), ...
+ * Each term is added with add(), which extends the tableau by a row, removing one
+ * more power of the width, and estimates the error from the difference of the last
+ * two diagonal entries.
+ */
+struct richardsonTableau {
+	double leading; //!<the factor the leading error term falls by from one term to the next
+	double ratio; //!<the factor the subdivisions are multiplied by
+	std::vector<double> previous; //!<the tableau's last row
+	std::vector<double> row; //!<the tableau's latest row, its diagonal entry last
+
+	/**
+	 * @param order the order of the rule's leading error term
+	 * @param ratio the factor the subdivisions are multiplied by
+	 */
+	richardsonTableau(int order, int ratio) :
+			leading(pow(ratio, order)), ratio(ratio) {
+	}
+
+	/**
+	 * Adds a term to the sequence and extrapolates its limit
+	 * @param term the next term of the sequence
+	 * @param [out] result the extrapolated limit
+	 * @param [out] abserror the estimated error of result
+	 * @return true if there were enough terms to estimate the error
+	 */
+	bool add(double term, double *result, double *abserror) {
+		previous.swap(row);
+		row.resize(previous.size() + 1);
+		row[0] = term;
+		double factor = leading;
+		for (size_t j = 1; j < row.size(); j++) {
+			row[j] = row[j - 1] + (row[j - 1] - previous[j - 1]) / (factor - 1);
+			factor *= ratio * ratio;
+		}
+		(*result) = row.back();
+		if (previous.empty())
+			return false;
+		(*abserror) = fabs(row.back() - previous.back());
+		return true;
+	}
+};
+}
+
+#endif /* EXTRAPOLATION_H_ */
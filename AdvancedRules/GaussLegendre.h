@@ -0,0 +1,156 @@
+/**
+ * @file GaussLegendre.h
+ * @brief Contains an O(n) generator of Gauss-Legendre nodes and weights
+ * Each node and weight is found independently, without iteration, from Bogaert's
+ * asymptotic expansions (I. Bogaert, "Iteration-free computation of Gauss-Legendre
+ * quadrature nodes and weights", SIAM J. Sci. Comput. 36, 2014) in terms of the
+ * zeros of the Bessel function J0, so n points take O(n) time and can be divided
+ * among threads. The expansions are accurate to double precision above MIN_POINTS.
+ * @author Irene Crowell
+ */
+#ifndef GAUSSLEGENDRE_H_
+#define GAUSSLEGENDRE_H_
+#include <math.h>
+
+namespace GaussLegendre {
+/**
+ * The fewest points for which the expansions are used (GSL builds smaller tables)
+ */
+const int MIN_POINTS = 101;
+
+/**
+ * Finds the kth positive zero of the Bessel function J0, from a table or
+ * McMahon's expansion
+ * @param k the index of the zero, from 1
+ * @return the zero
+ */
+inline double besselZero(long k) {
+	static const double ZEROS[20] = {
+		2.40482555769577276862e+0, 5.52007811028631064960e+0, 8.65372791291101221695e+0,
+		1.17915344390142816137e+1, 1.49309177084877859478e+1, 1.80710639679109225431e+1,
+		2.12116366298792589591e+1, 2.43524715307493027371e+1, 2.74934791320402547959e+1,
+		3.06346064684319751175e+1, 3.37758202135735686842e+1, 3.69170983536640439798e+1,
+		4.00584257646282392948e+1, 4.31997917131767303575e+1, 4.63411883716618140187e+1,
+		4.94826098973978171736e+1, 5.26240518411149960293e+1, 5.57655107550199793117e+1,
+		5.89069839260809421328e+1, 6.20484691902271698829e+1
+	};
+	if (k <= 20)
+		return ZEROS[k - 1];
+	double z = M_PI * (k - 0.25);
+	double r = 1 / z;
+	double r2 = r * r;
+	return z + r * (0.125 + r2 * (-0.807291666666666666666666666667e-1
+	      + r2 * (0.246028645833333333333333333333 + r2 * (-1.82443074544270833333333333333
+	      + r2 * (25.3364147973439050099206349206 + r2 * (-567.644412135183381139802038240
+	      + r2 * (18690.4765282320653831636345064 + r2 * (-8.49353580299148769921876983660e5
+	      + 5.09225462402226769498681286758e7 * r2))))))));
+}
+
+/**
+ * Finds the square of J1 at the kth positive zero of J0, from a table or an
+ * asymptotic expansion
+ * @param k the index of the zero, from 1
+ * @return J1(besselZero(k))^2
+ */
+inline double besselJ1Squared(long k) {
+	static const double J1_SQUARED[21] = {
+		2.69514123941916926139e-1, 1.15780138582203695808e-1, 7.36863511364082151406e-2,
+		5.40375731981162820418e-2, 4.26614290172430912655e-2, 3.52421034909961013587e-2,
+		3.00210701030546726751e-2, 2.61473914953080885905e-2, 2.31591218246913922653e-2,
+		2.07838291222678576040e-2, 1.88504506693176678161e-2, 1.72461575696650082995e-2,
+		1.58935181059235978027e-2, 1.47376260964721895896e-2, 1.37384651453871179183e-2,
+		1.28661817376151328791e-2, 1.20980515486267975471e-2, 1.14164712244916085169e-2,
+		1.08075927911802040116e-2, 1.02603729262807628110e-2, 9.76589713979105054060e-3
+	};
+	if (k <= 21)
+		return J1_SQUARED[k - 1];
+	double x = 1.0 / (k - 0.25);
+	double x2 = x * x;
+	return x * (0.202642367284675542887091093890 + x2 * x2
+	      * (-0.303380429711290253026202643516e-3 + x2 * (0.198924364245969295201137972743e-3
+	      + x2 * (-0.228969902772111653038747229723e-3 + x2 * (0.433710719130746277915572905025e-3
+	      + x2 * (-0.123632349727175414724737657367e-2 + x2 * (0.496101423268883102872271417616e-2
+	      + x2 * (-0.266837393702323757700998557826e-1 + 0.185395398206345628711318848386 * x2))))))));
+}
+
+/**
+ * Finds the kth node (counting from x = 1) and its weight of the n point rule.
+ * Only the nodes in [0,1] are found (k up to (n+1)/2), the others being their
+ * mirror images.
+ * @param n the number of points, at least MIN_POINTS
+ * @param k the index of the node, from 1 to (n+1)/2
+ * @param [out] x the node
+ * @param [out] weight its weight
+ */
+inline void node(long n, long k, double *x, double *weight) {
+	double w = 1.0 / (n + 0.5);
+	double nu = besselZero(k);
+	double theta = w * nu;
+	double t = theta * theta;
+	double b = besselJ1Squared(k);
+
+	// Chebyshev interpolants of the node's expansion...
+	double sf1 = (((((-1.29052996274280508473467968379e-12 * t
+	      + 2.40724685864330121825976175184e-10) * t
+	      - 3.13148654635992041468855740012e-8) * t
+	      + 0.275573168962061235623801563453e-5) * t
+	      - 0.148809523713909147898955880165e-3) * t
+	      + 0.416666666665193394525296923981e-2) * t
+	      - 0.416666666666662959639712457549e-1;
+	double sf2 = (((((+2.20639421781871003734786884322e-9 * t
+	      - 7.53036771373769326811030753538e-8) * t
+	      + 0.161969259453836261731700382098e-5) * t
+	      - 0.253300326008232025914059965302e-4) * t
+	      + 0.282116886057560434805998583817e-3) * t
+	      - 0.209022248387852902722635654229e-2) * t
+	      + 0.815972221772932265640401128517e-2;
+	double sf3 = (((((-2.97058225375526229899781956673e-8 * t
+	      + 5.55845330223796209655886325712e-7) * t
+	      - 0.567797841356833081642185432056e-5) * t
+	      + 0.418498100329504574443885193835e-4) * t
+	      - 0.251395293283965914823026348764e-3) * t
+	      + 0.128654198542845137196151147483e-2) * t
+	      - 0.416012165620204364833694266818e-2;
+	// ...and of the weight's
+	double wsf1 = ((((((((-2.20902861044616638398573427475e-14 * t
+	      + 2.30365726860377376873232578871e-12) * t
+	      - 1.75257700735423807659851042318e-10) * t
+	      + 1.03756066927916795821098009353e-8) * t
+	      - 4.63968647553221331251529631098e-7) * t
+	      + 0.149644593625028648361395938176e-4) * t
+	      - 0.326278659594412170300449074873e-3) * t
+	      + 0.436507936507598105249726413120e-2) * t
+	      - 0.305555555555553028279487898503e-1) * t
+	      + 0.833333333333333302184063103900e-1;
+	double wsf2 = (((((((+3.63117412152654783455929483029e-12 * t
+	      + 7.67643545069893130779501844323e-11) * t
+	      - 7.12912857233642220650643150625e-9) * t
+	      + 2.11483880685947151466370130277e-7) * t
+	      - 0.381817918680045468483009307090e-5) * t
+	      + 0.465969530694968391417927388162e-4) * t
+	      - 0.407297185611335764191683161117e-3) * t
+	      + 0.268959435694729660779984493795e-2) * t
+	      - 0.111111111111214923138249347172e-1;
+	double wsf3 = (((((((+2.01826791256703301806643264922e-9 * t
+	      - 4.38647122520206649251063212545e-8) * t
+	      + 5.08898347288671653137451093208e-7) * t
+	      - 0.397933316519135275712977531366e-5) * t
+	      + 0.200559326396458326778521795392e-4) * t
+	      - 0.422888059282921161626339411388e-4) * t
+	      - 0.105646050254076140548678457002e-3) * t
+	      - 0.947969308958577323145923317955e-4) * t
+	      + 0.656966489926484797412985260842e-2;
+
+	double nu_over_sin = nu / sin(theta);
+	double b_nu_over_sin = b * nu_over_sin;
+	double w_inv_sinc = w * w * nu_over_sin;
+	double wis2 = w_inv_sinc * w_inv_sinc;
+	theta = w * (nu + theta * w_inv_sinc * (sf1 + wis2 * (sf2 + wis2 * sf3)));
+	double denominator = b_nu_over_sin
+	      + b_nu_over_sin * wis2 * (wsf1 + wis2 * (wsf2 + wis2 * wsf3));
+	(*x) = cos(theta);
+	(*weight) = (2.0 * w) / denominator;
+}
+}
+
+#endif /* GAUSSLEGENDRE_H_ */
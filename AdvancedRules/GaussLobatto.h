@@ -0,0 +1,254 @@
+/**
+ * @file GaussLobatto.h
+ * @brief Contains the adaptive Gauss-Lobatto rule, whose subintervals share their ends
+ * As in Gander and Gautschi's adaptlob, each interval is integrated with the 4 point
+ * Gauss-Lobatto rule and its 7 point Kronrod extension, which share the interval's
+ * ends and 3 interior points. An interval which misses the error goal is divided at
+ * the 5 interior points into 6 subintervals, whose ends are all points already
+ * evaluated, so each subinterval only needs its own 5 interior points. Since the
+ * Kronrod rule is far more accurate than the Gauss-Lobatto rule, their difference
+ * overestimates its error, so (as in adaptlob) each interval need only meet the
+ * error goal for the whole integral, rather than its share of it.
+ * @author Irene Crowell
+ */
+#ifndef GAUSSLOBATTO_H_
+#define GAUSSLOBATTO_H_
+#include <math.h>
+#include <float.h>
+#include <ctime>
+#include <queue>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "../Frontier.h"
+#include "../Partition.h"
+#include "../NewtonCotesRules/BatchFunction.h"
+
+namespace GaussLobatto {
+/**
+ * The Kronrod points, sqrt(2/3), as a fraction of half the width from the middle
+ */
+const double ALPHA = 0.816496580927726032732428024902;
+/**
+ * The interior Gauss-Lobatto points, 1/sqrt(5), as a fraction of half the width
+ */
+const double BETA = 0.447213595499957939281834733746;
+/**
+ * The number of points evaluated for each interval (its ends are already known)
+ */
+const int NEW_POINTS = 5;
+/**
+ * The number of subintervals an interval is divided into
+ */
+const int PIECES = 6;
+
+/**
+ * The integral of an interval, with its error estimate
+ */
+struct estimate {
+	double result; //!<the integral by the Kronrod rule
+	double error; //!<the difference from the Gauss-Lobatto rule, or 0 if it is only rounding
+};
+
+/**
+ * A section to integrate, with the values at its ends
+ */
+struct interval {
+	double a; //!<the left (starting) point
+	double b; //!<the right (ending) point
+	double fa; //!<the value of the function at a, as found (it may not be finite)
+	double fb; //!<the value of the function at b, as found (it may not be finite)
+};
+
+/**
+ * Creates the whole interval, finding the values at its ends
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point
+ * @param b the right (ending) point
+ * @return the interval
+ */
+template<typename Function>
+interval wholeInterval(const Function &f, double a, double b) {
+	double x[2] = { a, b };
+	double fx[2];
+	evaluate(f, x, fx, 2);
+	return {a, b, fx[0], fx[1]};
+}
+
+/**
+ * Integrates an interval with the 4 point Gauss-Lobatto rule and its 7 point Kronrod
+ * extension, and finds the 6 subintervals it would be divided into.
+ * The subintervals keep the values as found, so with the deferredRepair policy a
+ * value which is not finite is repaired again relative to the width of each
+ * interval using it, rather than once for the widest. A difference no larger than
+ * the rounding of the Kronrod rule's sum is taken as no error, since the error goal
+ * (relative to the width) can fall below rounding for narrow intervals where the
+ * function is large.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param current the interval
+ * @param [out] pieces the subintervals, from left to right
+ * @return the integral by the Kronrod rule, and its error estimate
+ */
+template<typename Policy, typename Function>
+estimate lobattoKronrod(const Function &f, const interval &current,
+      interval *pieces) {
+	double m = 0.5 * (current.a + current.b);
+	double h = 0.5 * (current.b - current.a);
+	double x[NEW_POINTS + 2] = { current.a, m - ALPHA * h, m - BETA * h, m, m
+	      + BETA * h, m + ALPHA * h, current.b };
+	double fx[NEW_POINTS + 2];
+	evaluate(f, x + 1, fx + 1, NEW_POINTS);
+	fx[0] = current.fa;
+	fx[NEW_POINTS + 1] = current.fb;
+	for (int i = 0; i < PIECES; i++) {
+		pieces[i] = {x[i], x[i + 1], fx[i], fx[i + 1]};
+	}
+	if (Policy::repair) {
+		for (int i = 0; i < NEW_POINTS + 2; i++) {
+			if (!(fabs(fx[i]) <= DBL_MAX)) // true for inf and NaN
+				fx[i] = repairVal(f, x[i], current.b - current.a);
+		}
+	}
+
+	double ends = fx[0] + fx[6];
+	double lobatto = h / 6 * (ends + 5 * (fx[2] + fx[4]));
+	double kronrod = h / 1470 * (77 * ends + 432 * (fx[1] + fx[5])
+	      + 625 * (fx[2] + fx[4]) + 672 * fx[3]);
+	double resabs = fabs(h) / 1470 * (77 * (fabs(fx[0]) + fabs(fx[6]))
+	      + 432 * (fabs(fx[1]) + fabs(fx[5])) + 625 * (fabs(fx[2]) + fabs(fx[4]))
+	      + 672 * fabs(fx[3]));
+	double error = fabs(kronrod - lobatto);
+	if (error <= 100 * DBL_EPSILON * resabs)
+		error = 0; // only rounding
+	return {kronrod, error};
+}
+
+/**
+ * Finds the goal for the error estimate of every interval, from a first estimate of
+ * the integral with the rule on the whole interval
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal (absolute, or relative to the integral)
+ * @return the (absolute) goal
+ */
+template<typename Policy, typename Function>
+double intervalGoal(const Function &f, double a, double b, double error) {
+	interval pieces[PIECES];
+	estimate whole = lobattoKronrod<Policy>(f, wholeInterval(f, a, b), pieces);
+	if (!(fabs(whole.result) <= DBL_MAX))
+		return error;
+	return std::max(error, error * fabs(whole.result));
+}
+
+/**
+ * @param current the interval
+ * @param pieces its subintervals
+ * @param min_width the narrowest interval to divide further
+ * @return true if the interval can be divided (its points are distinct, and it is
+ * wide enough)
+ */
+inline bool divisible(const interval &current, const interval *pieces,
+      double min_width) {
+	return current.b - current.a >= min_width && pieces[0].a < pieces[0].b
+	      && pieces[PIECES - 1].a < pieces[PIECES - 1].b;
+}
+
+/**
+ * Calculates the numerical integral using the adaptive Gauss-Lobatto rule.
+ * The adaptive rule divides each section in six until the difference of its two
+ * rules meets the error goal.
+ * @param f	the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal (absolute, or relative to the integral)
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+template<typename Policy, typename Function>
+double adaptiveNonParallel(const Function &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions) {
+	(*subdivisions) = 1;
+	std::clock_t start = std::clock();
+	double goal = intervalGoal<Policy>(f, a, b, error);
+	std::queue<interval> intervals;
+	intervals.push(wholeInterval(f, a, b));
+	double result = 0;
+	double min_width = (b - a) * DBL_EPSILON; // narrower intervals are not divided
+	bool subdivisions_exceeded = false;
+	bool time_exceeded = false;
+	interval pieces[PIECES];
+	while (!intervals.empty()) {
+		if (((std::clock() - start) / (double) CLOCKS_PER_SEC) > max_time)
+			time_exceeded = true;
+		if ((*subdivisions) > max_subdivisions)
+			subdivisions_exceeded = true;
+		interval currentInterval = intervals.front();
+		intervals.pop();
+		estimate integral = lobattoKronrod<Policy>(f, currentInterval, pieces);
+		if (integral.error <= goal
+		      || !divisible(currentInterval, pieces, min_width)
+		      || subdivisions_exceeded || time_exceeded) {
+			result += integral.result;
+		} else {
+			for (int i = 0; i < PIECES; i++) {
+				intervals.push(pieces[i]);
+			}
+			(*subdivisions) += PIECES - 1;
+		}
+	}
+	return result;
+}
+/**
+ * Calculates using parallel threads the numerical integral using the adaptive
+ * Gauss-Lobatto rule.
+ * The threads start from the intervals of balancedPartition()'s pilot which miss
+ * the error goal (see pilotStarts()), each taking a run of neighbours, and idle
+ * threads steal intervals from the others (see Frontier::parallel()).
+ * @param f	the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal (absolute, or relative to the integral)
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+template<typename Policy, typename Function>
+double adaptiveParallel(const Function &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      int *subdivisions, double *utilization) {
+	double goal = intervalGoal<Policy>(f, a, b, error);
+	partialSum finished;
+	int count;
+	std::vector<interval> starts;
+	for (const pilotInterval &pilot : pilotStarts(f, a, b, num_threads,
+	      goal / fabs(b - a), &finished, &count)) {
+		starts.push_back(wholeInterval(f, pilot.a, pilot.b));
+	}
+	double min_width = (b - a) * DBL_EPSILON; // narrower intervals are not divided
+	auto step = [&](const interval &current, bool stop, partialSum *sum,
+	      interval *subintervals) {
+		estimate integral = lobattoKronrod<Policy>(f, current, subintervals);
+		sum->evaluations += NEW_POINTS;
+		if (integral.error <= goal || !divisible(current, subintervals, min_width)
+		      || stop) {
+			sum->value += integral.result;
+			return 0;
+		}
+		return PIECES;
+	};
+	double result = Frontier::parallel<interval, PIECES>(starts, step,
+	      num_threads, max_subdivisions, max_time, subdivisions,
+	      utilization).value;
+	(*subdivisions) += count;
+	return finished.value + result;
+}
+}
+
+#endif /* GAUSSLOBATTO_H_ */
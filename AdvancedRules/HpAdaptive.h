@@ -0,0 +1,354 @@
+/**
+ * @file HpAdaptive.h
+ * @brief Contains the hp-adaptive Newton-Cotes rule, which raises the order of each
+ * interval where the function is smooth and divides it where it is not
+ * Each interval keeps the values at 2^k+1 equally spaced points (its level k). They
+ * are integrated with the trapezoid, Simpson's and Boole's rules, with their weights
+ * from RuleHeaders.h, and with Romberg's extrapolation of these to higher orders, so
+ * level k gives a rule of order 2k+2. How quickly the successive orders' results
+ * settle shows how smooth the function is: where each difference is far smaller
+ * than the last, the interval doubles its points to raise its order, and elsewhere
+ * (kinks, jumps and singularities) it is divided in two. The points are nested both
+ * ways, so raising the order only evaluates the new midpoints, and each half keeps
+ * its share of the points at one level lower, without evaluating any.
+ * @author Irene Crowell
+ */
+#ifndef HPADAPTIVE_H_
+#define HPADAPTIVE_H_
+#include <math.h>
+#include <float.h>
+#include <ctime>
+#include <array>
+#include <queue>
+#include <vector>
+#include <atomic>
+#include "../Frontier.h"
+#include "../Partition.h"
+#include "../NewtonCotesRules/RuleHeaders.h"
+
+namespace HpAdaptive {
+/**
+ * The lowest level, Boole's rule on 5 points (the first with two differences)
+ */
+const int MIN_LEVEL = 2;
+/**
+ * The highest level, 33 points (order 12), beyond which intervals are only divided
+ */
+const int MAX_LEVEL = 5;
+/**
+ * An interval is smooth if the last difference of its results is at most this
+ * fraction of the one before (the order rising by more than 4)
+ */
+const double SMOOTH_DECAY = 1.0 / 16;
+/**
+ * An interval's error is only rounding if it is at most this many times the
+ * rounding of the sum of |f|, over the interval or over the whole integral
+ */
+const double ROUNDING = 100 * DBL_EPSILON;
+
+/**
+ * A section to integrate, with the values at its points
+ */
+struct interval {
+	double a; //!<the left (starting) point
+	double b; //!<the right (ending) point
+	int level; //!<the interval has 2^level+1 points
+	std::array<double, (1 << MAX_LEVEL) + 1> f; //!<the values of the function at the points, from a to b
+};
+
+/**
+ * The integral of an interval, with its error estimate
+ */
+struct estimate {
+	double result; //!<the integral by the highest order
+	double error; //!<the difference from the order below, or 0 if it is only rounding
+	bool smooth; //!<true if the differences fell quickly enough to raise the order
+	double resabs; //!<the integral of |f|
+};
+
+/**
+ * Applies a rule from RuleHeaders.h with equally spaced nodes, including both ends,
+ * as a composite rule on some of an interval's points
+ * @param values the values at the interval's points
+ * @param stride the distance (in points) between the points used
+ * @param steps the number of steps between the points used (a multiple of the
+ * rule's)
+ * @param width the width of the interval
+ * @return the integral
+ */
+template<typename Rule>
+double compositeRule(const double *values, int stride, int steps,
+      double width) {
+	static_assert(NewtonCotes::sharedEnds<Rule>(), "the rule must include its ends");
+	constexpr int spacing = Rule::nodes[1] - Rule::nodes[0];
+	constexpr int panel = Rule::GRID / spacing; // the steps in each panel
+	double sum = 0;
+	for (int p = 0; p < steps; p += panel) {
+		for (size_t k = 0; k < Rule::nodes.size(); k++) {
+			sum += Rule::weights[k] * values[(p + Rule::nodes[k] / spacing) * stride];
+		}
+	}
+	return sum * width * panel / (steps * Rule::divisor);
+}
+
+/**
+ * Integrates an interval at every level up to its own, and estimates its error and
+ * smoothness.
+ * Column j of Romberg's tableau at level i is the composite trapezoid, Simpson's or
+ * Boole's rule on 2^i steps for j = 0, 1 or 2, and extrapolated from column j-1
+ * after that. The results are the diagonal, level i with column i. A difference no
+ * larger than the rounding of the sum is taken as no error.
+ * @param current the interval
+ * @return the integral by the highest order, and its error estimate
+ */
+inline estimate tableau(const interval &current) {
+	const int k = current.level;
+	const double width = current.b - current.a;
+	double columns[MAX_LEVEL + 1][MAX_LEVEL + 1];
+	for (int i = 0; i <= k; i++) {
+		int steps = 1 << i;
+		int stride = 1 << (k - i);
+		columns[i][0] = compositeRule<TrapezoidRule::rule>(current.f.data(), stride,
+		      steps, width);
+		if (i >= 1)
+			columns[i][1] = compositeRule<SimpsonRule::rule>(current.f.data(),
+			      stride, steps, width);
+		if (i >= 2)
+			columns[i][2] = compositeRule<BoolesRule::rule>(current.f.data(), stride,
+			      steps, width);
+		for (int j = 3; j <= i; j++) {
+			columns[i][j] = columns[i][j - 1]
+			      + (columns[i][j - 1] - columns[i - 1][j - 1]) / (ldexp(1, 2 * j) - 1);
+		}
+	}
+	double resabs = 0;
+	for (int i = 0; i <= (1 << k); i++) {
+		resabs += fabs(current.f[i]);
+	}
+	resabs *= fabs(width) / (1 << k);
+
+	double error = fabs(columns[k][k] - columns[k - 1][k - 1]);
+	double previous = fabs(columns[k - 1][k - 1] - columns[k - 2][k - 2]);
+	bool smooth = error <= SMOOTH_DECAY * previous;
+	if (error <= ROUNDING * resabs)
+		error = 0; // only rounding
+	return {columns[k][k], error, smooth, resabs};
+}
+
+/**
+ * Raises an interval's level by one, finding the values at the midpoints of its
+ * steps
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param [out] current the interval
+ * @return the number of points evaluated
+ */
+template<typename Policy, typename Function>
+int raise(const Function &f, interval *current) {
+	const int steps = 1 << current->level;
+	const double width = current->b - current->a;
+	double x[1 << (MAX_LEVEL - 1)];
+	double fx[1 << (MAX_LEVEL - 1)];
+	for (int i = 0; i < steps; i++) {
+		x[i] = current->a + width * (2 * i + 1) / (2 * steps);
+	}
+	findVals<Policy>(f, x, fx, steps, width);
+	for (int i = steps; i >= 0; i--) { // spread out the old points
+		current->f[2 * i] = current->f[i];
+	}
+	for (int i = 0; i < steps; i++) {
+		current->f[2 * i + 1] = fx[i];
+	}
+	current->level++;
+	return steps;
+}
+
+/**
+ * Creates an interval at the lowest level
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point
+ * @param b the right (ending) point
+ * @return the interval
+ */
+template<typename Policy, typename Function>
+interval wholeInterval(const Function &f, double a, double b) {
+	interval whole { a, b, 0, { } };
+	double x[2] = { a, b };
+	findVals<Policy>(f, x, whole.f.data(), 2, b - a);
+	while (whole.level < MIN_LEVEL) {
+		raise<Policy>(f, &whole);
+	}
+	return whole;
+}
+
+/**
+ * Divides an interval in two, each half keeping its points at one level lower (and
+ * raised to the lowest level, if it is below)
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param current the interval
+ * @param [out] left the left half
+ * @param [out] right the right half
+ * @return the number of points evaluated
+ */
+template<typename Policy, typename Function>
+int bisect(const Function &f, const interval &current, interval *left,
+      interval *right) {
+	const int half = 1 << (current.level - 1);
+	double m = current.a + 0.5 * (current.b - current.a);
+	(*left) = {current.a, m, current.level - 1, { }};
+	(*right) = {m, current.b, current.level - 1, { }};
+	for (int i = 0; i <= half; i++) {
+		left->f[i] = current.f[i];
+		right->f[i] = current.f[half + i];
+	}
+	int evaluations = 0;
+	while (left->level < MIN_LEVEL) {
+		evaluations += raise<Policy>(f, left);
+		evaluations += raise<Policy>(f, right);
+	}
+	return evaluations;
+}
+
+/**
+ * Integrates an interval, raising its level while it is smooth and misses the error
+ * goal. If raising the level does not reduce the error estimate, the interval stops
+ * there, so that it is divided instead.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param error the error goal (for each unit of width)
+ * @param [out] current the interval, at its final level
+ * @param [out] evaluations incremented by the number of points evaluated
+ * @return the integral of the interval at its final level
+ */
+template<typename Policy, typename Function>
+estimate integrate(const Function &f, double error, interval *current,
+      long *evaluations) {
+	estimate integral = tableau(*current);
+	while (integral.error > error * (current->b - current->a) && integral.smooth
+	      && current->level < MAX_LEVEL) {
+		double last = integral.error;
+		(*evaluations) += raise<Policy>(f, current);
+		integral = tableau(*current);
+		if (integral.error >= last)
+			break;
+	}
+	return integral;
+}
+
+/**
+ * @param integral an interval's integral
+ * @param error the error goal (for each unit of width)
+ * @param width the interval's width
+ * @param rounding the rounding of the whole integral (ROUNDING times its
+ * integral of |f|)
+ * @return true if the interval's error meets the goal, or is below the rounding of
+ * the whole integral, where dividing it further cannot change the result (as where
+ * the function's values are only noise)
+ */
+inline bool converged(const estimate &integral, double error, double width,
+      double rounding) {
+	return integral.error <= error * width || integral.error <= rounding;
+}
+
+/**
+ * Calculates the numerical integral using the hp-adaptive Newton-Cotes rule.
+ * Each interval raises its order while it is smooth, and is divided in two if it
+ * still misses the error goal.
+ * @param f	the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+template<typename Policy, typename Function>
+double adaptiveNonParallel(const Function &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions) {
+	(*subdivisions) = 1;
+	std::clock_t start = std::clock();
+	std::queue<interval> intervals;
+	intervals.push(wholeInterval<Policy>(f, a, b));
+	double rounding = ROUNDING * tableau(intervals.front()).resabs;
+	double result = 0;
+	long evaluations = 0;
+	double min_width = (b - a) * DBL_EPSILON * (1 << MAX_LEVEL); // narrower intervals are not divided
+	bool subdivisions_exceeded = false;
+	bool time_exceeded = false;
+	interval left;
+	interval right;
+	while (!intervals.empty()) {
+		if (((std::clock() - start) / (double) CLOCKS_PER_SEC) > max_time)
+			time_exceeded = true;
+		if ((*subdivisions) > max_subdivisions)
+			subdivisions_exceeded = true;
+		interval currentInterval = intervals.front();
+		intervals.pop();
+		estimate integral = integrate<Policy>(f, error, &currentInterval,
+		      &evaluations);
+		double width = currentInterval.b - currentInterval.a;
+		if (converged(integral, error, width, rounding) || width < min_width
+		      || subdivisions_exceeded || time_exceeded) {
+			result += integral.result;
+		} else {
+			bisect<Policy>(f, currentInterval, &left, &right);
+			intervals.push(left);
+			intervals.push(right);
+			(*subdivisions)++;
+		}
+	}
+	return result;
+}
+/**
+ * Calculates using parallel threads the numerical integral using the hp-adaptive
+ * Newton-Cotes rule.
+ * The threads start from the intervals of balancedPartition()'s pilot which miss
+ * the error goal (see pilotStarts()), each taking a run of neighbours, and idle
+ * threads steal intervals from the others (see Frontier::parallel()).
+ * @param f	the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+template<typename Policy, typename Function>
+double adaptiveParallel(const Function &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      int *subdivisions, double *utilization) {
+	partialSum finished;
+	int count;
+	std::vector<interval> starts;
+	double resabs = 0; // of the starts, and (roughly) of the finished intervals
+	for (const pilotInterval &pilot : pilotStarts(f, a, b, num_threads, error,
+	      &finished, &count)) {
+		starts.push_back(wholeInterval<Policy>(f, pilot.a, pilot.b));
+		resabs += tableau(starts.back()).resabs;
+	}
+	double rounding = ROUNDING * (resabs + fabs(finished.value));
+	double min_width = (b - a) * DBL_EPSILON * (1 << MAX_LEVEL); // narrower intervals are not divided
+	auto step = [&](interval current, bool stop, partialSum *sum,
+	      interval *halves) {
+		estimate integral = integrate<Policy>(f, error, &current,
+		      &sum->evaluations);
+		double width = current.b - current.a;
+		if (converged(integral, error, width, rounding) || width < min_width
+		      || stop) {
+			sum->value += integral.result;
+			return 0;
+		}
+		sum->evaluations += bisect<Policy>(f, current, &halves[0], &halves[1]);
+		return 2;
+	};
+	double result = Frontier::parallel<interval, 2>(starts, step, num_threads,
+	      max_subdivisions, max_time, subdivisions, utilization).value;
+	(*subdivisions) += count;
+	return finished.value + result;
+}
+}
+
+#endif /* HPADAPTIVE_H_ */
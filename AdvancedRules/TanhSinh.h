@@ -0,0 +1,178 @@
+/**
+ * @file TanhSinh.h
+ * @brief Contains the tanh-sinh (double exponential) rule, for endpoint singularities
+ * Substituting x = tanh(pi/2 sinh(t)) turns [-1,1] into the whole real line, with the
+ * weights falling double exponentially towards the ends, so the trapezoid rule in t
+ * converges quickly even when the function is singular at an end. Each level halves
+ * the step in t, so it only adds the points between the previous level's, and every
+ * earlier value is reused. Points are stored by their distance from the nearer end,
+ * so they can be placed right next to a singularity without rounding onto it.
+ * @author Irene Crowell
+ */
+#ifndef TANHSINH_H_
+#define TANHSINH_H_
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <vector>
+#include "../ThreadPool.h"
+#include "../PartialSum.h"
+#include "../NewtonCotesRules/BatchFunction.h"
+
+namespace TanhSinh {
+/**
+ * The most levels the tables hold (level k has a step of 2^-k in t)
+ */
+const int MAX_LEVEL = 12;
+/**
+ * The largest t used, where the points are within 1e-275 of the ends
+ */
+const double T_MAX = 6;
+
+/**
+ * One point of the rule on [-1,1], with its mirror image at -t
+ */
+struct node {
+	double t; //!<the point before the substitution
+	double complement; //!<1-x, the distance of x from 1 (and of -x from -1)
+	double weight; //!<the weight of x (and of -x), before multiplying by the step
+};
+
+/**
+ * Finds the points each level adds, computing them on first use.
+ * Level 0 holds t = 1, 2, ..., and level k the odd multiples of 2^-k, in order of
+ * t; the point t = 0 is not stored. The tables are shared by every thread.
+ * @return the points of each level, from 0 to MAX_LEVEL
+ */
+inline const std::vector<std::vector<node>> &levels() {
+	static const std::vector<std::vector<node>> tables = [] {
+		std::vector<std::vector<node>> levels(MAX_LEVEL + 1);
+		for (int k = 0; k <= MAX_LEVEL; k++) {
+			double step = k ? ldexp(1, -k) : 1;
+			for (long j = 1; (k ? 2 * j - 1 : j) * step <= T_MAX; j++) {
+				double t = (k ? 2 * j - 1 : j) * step;
+				double u = M_PI_2 * sinh(t);
+				double cosh_u = cosh(u);
+				levels[k].push_back( { t, exp(-u) / cosh_u, M_PI_2 * cosh(t)
+				      / (cosh_u * cosh_u) });
+			}
+		}
+		return levels;
+	}();
+	return tables;
+}
+
+/**
+ * Sums the weighted values of a function at points first to last-1 of a level, and
+ * at their mirror images. Points which round onto an end are left out, and values
+ * which are not finite are repaired relative to their distance from the end.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param nodes the level's points
+ * @param first the first point to sum
+ * @param last one past the last point to sum
+ * @return the weighted sum, before multiplying by the step and half the width
+ */
+template<typename Function>
+double levelSum(const Function &f, double a, double b,
+      const std::vector<node> &nodes, long first, long last) {
+	const double half = 0.5 * (b - a);
+	double x[BATCH_SIZE];
+	double fx[BATCH_SIZE];
+	double distance[BATCH_SIZE];
+	double weight[BATCH_SIZE];
+	double sum = 0;
+	long j = first;
+	while (j < last) {
+		int n = 0;
+		for (; j < last && n <= BATCH_SIZE - 2; j++) {
+			double d = half * nodes[j].complement;
+			if (a + d > a) { // the left point
+				x[n] = a + d;
+				distance[n] = d;
+				weight[n++] = nodes[j].weight;
+			}
+			if (b - d < b) { // the right point
+				x[n] = b - d;
+				distance[n] = d;
+				weight[n++] = nodes[j].weight;
+			}
+		}
+		evaluate(f, x, fx, n);
+		for (int i = 0; i < n; i++) {
+			if (!(fabs(fx[i]) <= DBL_MAX)) // true for inf and NaN
+				fx[i] = repairVal(f, x[i], distance[i]);
+			sum += weight[i] * fx[i];
+		}
+	}
+	return sum;
+}
+
+/**
+ * Calculates the numerical integral using the tanh-sinh rule, adding levels until
+ * the change from the last level meets the error goal.
+ * Level 0 also finds where the terms fall below rounding, and later levels only
+ * use points up to one past there. With more than one thread, the points of each
+ * level are divided among the threads.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param error the error goal (absolute, or relative to the result)
+ * @param max_levels the most levels to use (at most MAX_LEVEL)
+ * @param num_threads the number of parallel threads to run
+ * @param [out] abserror the estimated error achieved
+ * @param [out] levels_used the number of levels used
+ * @return the numerically integrated value
+ */
+template<typename Function>
+double integrate(const Function &f, double a, double b, double error,
+      int max_levels, int num_threads, double *abserror, int *levels_used) {
+	const std::vector<std::vector<node>> &tables = levels();
+	const double half = 0.5 * (b - a);
+	max_levels = std::min(max_levels, MAX_LEVEL);
+
+	// level 0, one point at a time, to find where the terms become negligible
+	double center = 0.5 * (a + b);
+	double sum = M_PI_2 * findVal(f, center, half);
+	double t_cut = 0;
+	std::vector<double> terms;
+	for (long j = 0; j < (long) tables[0].size(); j++) {
+		terms.push_back(levelSum(f, a, b, tables[0], j, j + 1));
+		sum += terms.back();
+	}
+	for (long j = 0; j < (long) terms.size(); j++) {
+		if (fabs(terms[j]) > DBL_EPSILON * fabs(sum))
+			t_cut = tables[0][j].t;
+	}
+	t_cut += 1;
+	double result = half * sum;
+	(*abserror) = fabs(result);
+	(*levels_used) = 1;
+
+	std::vector<partialSum> partials(num_threads);
+	for (int k = 1; k <= max_levels; k++) {
+		const std::vector<node> &nodes = tables[k];
+		long count = std::upper_bound(nodes.begin(), nodes.end(), t_cut,
+		      [](double t, const node &n) {return t < n.t;}) - nodes.begin();
+		if (num_threads > 1) {
+			ThreadPool::getInstance().run(num_threads, [&](int i) {
+				partials[i].value = levelSum(f, a, b, nodes, count * i / num_threads,
+				      count * (i + 1) / num_threads);
+			});
+			sum += sumPartials(partials).value;
+		} else {
+			sum += levelSum(f, a, b, nodes, 0, count);
+		}
+		double previous = result;
+		result = half * ldexp(sum, -k);
+		(*abserror) = fabs(result - previous);
+		(*levels_used) = k + 1;
+		if ((*abserror) <= std::max(error, error * fabs(result)))
+			break;
+	}
+	return result;
+}
+}
+
+#endif /* TANHSINH_H_ */
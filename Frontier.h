@@ -0,0 +1,114 @@
+/**
+ * @file Frontier.h
+ * @brief Contains the parallel driver shared by the locally adaptive rules
+ * Each thread refines the intervals of its own queue of a WorkStealingQueue, and an
+ * interval which misses its goal is replaced by its pieces, the leftmost refined
+ * next. The rules differ only in their interval and in the step which integrates
+ * one and divides it, so each supplies those and the driver does the rest.
+ * @author Irene Crowell
+ */
+#ifndef FRONTIER_H_
+#define FRONTIER_H_
+#include <ctime>
+#include <vector>
+#include <atomic>
+#include "ThreadPool.h"
+#include "WorkStealingQueue.h"
+#include "PartialSum.h"
+
+namespace Frontier {
+/**
+ * The number of subdivisions a thread counts itself before adding them to the
+ * shared count (so the limit may be passed by this many for each thread)
+ */
+const int SUBDIVISION_BATCH = 64;
+
+/**
+ * For threading -- Integrates intervals from a thread's queue (or stolen from the
+ * others) until every queue is empty.
+ * @param step integrates an interval: step(current, stop, &sum, pieces) adds the
+ * evaluations it makes to sum, and either adds the interval's integral to sum and
+ * returns 0, or writes its pieces (from left to right) and returns their number.
+ * It must not divide the interval if stop is true.
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param threadNum the identifying member of this thread (0 to threads-1)
+ * @param intervals pointer to the per-thread queues of intervals to be integrated
+ * @param [out] partial this thread's sum of the integrals of the sections
+ * @param [out] subdivisions the number of subdivisions used (counted in batches of
+ * SUBDIVISION_BATCH)
+ */
+template<typename Interval, int Pieces, typename Step>
+void thread(const Step &step, int max_subdivisions, int max_time,
+      int threadNum, WorkStealingQueue<Interval> *intervals,
+      partialSum *partial, std::atomic<int> *subdivisions) {
+	std::clock_t start = std::clock();
+	bool subdivisions_exceeded = false;
+	bool time_exceeded = false;
+	partialSum sum;
+	int subdivided = 0; // not yet added to the shared count
+	Interval currentInterval;
+	Interval pieces[Pieces];
+	while (intervals->pop(threadNum, &currentInterval)) {
+		if (((std::clock() - start) / (double) CLOCKS_PER_SEC) > max_time)
+			time_exceeded = true;
+		if ((*subdivisions) + subdivided > max_subdivisions)
+			subdivisions_exceeded = true;
+		int count = step(currentInterval,
+		      subdivisions_exceeded || time_exceeded, &sum, pieces);
+		for (int i = count - 1; i >= 0; i--) { // refining the leftmost next
+			intervals->push(threadNum, pieces[i]);
+		}
+		if (count > 0)
+			subdivided += count - 1;
+		if (subdivided >= SUBDIVISION_BATCH) {
+			(*subdivisions) += subdivided;
+			subdivided = 0;
+		}
+	}
+	(*subdivisions) += subdivided;
+	(*partial) = sum;
+}
+
+/**
+ * Integrates intervals on parallel threads, dividing each which misses its goal.
+ * The starting intervals are shared out in order, each thread taking a run of
+ * neighbours, and idle threads steal intervals from the others.
+ * @param starts the intervals to start from, from left to right
+ * @param step integrates an interval and divides it if it misses its goal (see
+ * thread())
+ * @param num_threads the number of parallel threads to run
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the total of every thread's partialSum
+ */
+template<typename Interval, int Pieces, typename Step>
+partialSum parallel(const std::vector<Interval> &starts, const Step &step,
+      int num_threads, int max_subdivisions, int max_time, int *subdivisions,
+      double *utilization) {
+	std::atomic<int> subdivided(starts.size());
+	WorkStealingQueue<Interval> intervals(num_threads);
+	long count = starts.size();
+	for (int i = 0; i < num_threads; i++) { // in reverse, so the leftmost is first
+		for (long j = count * (i + 1) / num_threads - 1; j >= count * i / num_threads;
+		      j--) {
+			intervals.push(i, starts[j]);
+		}
+	}
+	std::vector<partialSum> partials(num_threads);
+
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		thread<Interval, Pieces>(step, max_subdivisions, max_time, i, &intervals,
+		      &partials[i], &subdivided);
+	});
+	(*subdivisions) = subdivided;
+	if (utilization)
+		(*utilization) = intervals.utilization();
+	return sumPartials(partials);
+}
+}
+
+#endif /* FRONTIER_H_ */
@@ -12,6 +12,7 @@
 #include <array>
 #include <string>
 #include <vector>
+#include "NewtonCotesRules/BatchFunction.h"
 /**
  * Provides an array of 24 integrableFunctions to be integrated
  */
@@ -24,11 +25,13 @@ public:
 	 */
 	struct integrableFunction {
 		gsl_function f; //!<the function to be integrated
+		batchFunctionPointer batch; //!<the same function, vectorised over a block of points
 		double a; //!<the left (starting) point
 		double b; //!<the right (ending) point
 		double value; //!<the symbolically calculated integral
 		std::string name; //!<a description of the function, ex: sin(x)
 		std::string type; //!<either simple, discontinuous, or badly behaved
+		bool wellBehaved; //!<true if the function is finite everywhere in [a, b], so its values need no repair
 		double singularity; //!<a singular point, if one exists
 	};
 
@@ -0,0 +1,40 @@
+/**
+ * @file AllRules.cpp
+ * @brief contains functions for calculations with all five Newton-Cotes rules at
+ * once.
+ * The rules' points are placed on one shared grid, and the function is evaluated
+ * once at each, so comparing the rules costs little more than the rule with the
+ * most points.
+ * @author Irene Crowell
+ */
+#include "RuleHeaders.h"
+
+namespace AllRules {
+/**
+ * Calculates the numerical integral using each of the five composite rules
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @return each rule's numerically integrated value
+ */
+std::array<double, RULES> nonAdaptiveNonParallel(const batchFunction &f,
+      double a, double b, int subdivisions) {
+	return nonAdaptiveNonParallel<deferredRepair>(f, a, b, subdivisions);
+}
+/**
+ * Calculates using parallel sections the integral using each of the five
+ * composite rules
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @return each rule's numerically integrated value
+ */
+std::array<double, RULES> nonAdaptiveParallel(const batchFunction &f, double a,
+      double b, int subdivisions, int num_threads) {
+	return nonAdaptiveParallel<deferredRepair>(f, a, b, subdivisions,
+	      num_threads);
+}
+}
@@ -0,0 +1,221 @@
+/**
+ * @file BatchFunction.h
+ * @brief Allows for calculation of a function at a block of points at once
+ * @author Irene Crowell
+ */
+#ifndef BATCHFUNCTION_H_
+#define BATCHFUNCTION_H_
+#include <gsl/gsl_math.h>
+#include <float.h>
+#include <algorithm>
+#include <array>
+#include "FindVal.h"
+
+/**
+ * The most points the rules evaluate in one call
+ */
+const int BATCH_SIZE = 16;
+
+/**
+ * Fills fx[i] with the function's value at x[i], for i from 0 to n-1
+ */
+typedef void (*batchFunctionPointer)(const double *x, double *fx, int n,
+      void *params);
+
+/**
+ * A function which can be evaluated at many points in one call.
+ * Integrands which can vectorise (or otherwise share work between points)
+ * supply function, and any gsl_function converts to a batchFunction which
+ * evaluates it one point at a time, so the rules accept either.
+ */
+struct batchFunction {
+	batchFunctionPointer function; //!<evaluates a block of points, or NULL to call scalar for each
+	void *params; //!<the parameters passed to function
+	gsl_function scalar; //!<the same function at one point, used for singularities
+
+	/**
+	 * Wraps a gsl_function, which is then evaluated one point at a time
+	 * @param f the function to wrap
+	 */
+	batchFunction(gsl_function f) :
+			function(NULL), params(NULL), scalar(f) {
+	}
+	/**
+	 * @param function evaluates a block of points
+	 * @param params the parameters passed to function
+	 * @param scalar the same function at one point
+	 */
+	batchFunction(batchFunctionPointer function, void *params,
+	      gsl_function scalar) :
+			function(function), params(params), scalar(scalar) {
+	}
+};
+
+/**
+ * Evaluation policy for functions which are finite wherever the rules evaluate
+ * them: values are used as they are, without checking for singularities
+ */
+struct unchecked {
+	static constexpr bool repair = false; //!<whether findVals() repairs values
+};
+/**
+ * Evaluation policy for functions which may have singularities: a block is
+ * evaluated first, then only its values which are not finite are repaired
+ */
+struct deferredRepair {
+	static constexpr bool repair = true; //!<whether findVals() repairs values
+};
+
+/**
+ * Enables a template for the functions the rules accept: a batchFunction or a callable
+ */
+template<typename Function>
+using ifEvaluable = typename std::enable_if<
+      std::is_same<Function, batchFunction>::value
+            || std::is_invocable_r<double, const Function&, double>::value,
+      int>::type;
+
+/**
+ * Calculates a function's values at a block of points, without checking them
+ * @param f the function to find the values of
+ * @param x the points to find the values at
+ * @param [out] fx the values of f at x
+ * @param n the number of points
+ */
+inline void evaluate(const batchFunction &f, const double *x, double *fx,
+      int n) {
+	if (f.function) {
+		f.function(x, fx, n, f.params);
+	} else {
+		for (int i = 0; i < n; i++) {
+			fx[i] = f.scalar.function(x[i], f.scalar.params);
+		}
+	}
+}
+/**
+ * Calculates a callable's values at a block of points, without checking them.
+ * The callable is called directly, so it can be inlined (and the loop vectorised)
+ * where it is instantiated.
+ * @param f the function to find the values of, called as f(x)
+ * @param x the points to find the values at
+ * @param [out] fx the values of f at x
+ * @param n the number of points
+ */
+template<typename Function, ifIntegrand<Function> = 0>
+inline void evaluate(const Function &f, const double *x, double *fx, int n) {
+	for (int i = 0; i < n; i++) {
+		fx[i] = f(x[i]);
+	}
+}
+/**
+ * Replaces a batchFunction's value at a singularity, as repairVal() does
+ * @param f the function
+ * @param x the point where f is not finite
+ * @param width the "width" to consider as close to the point.
+ * @return the repaired value of f at x
+ */
+inline double repairVal(const batchFunction &f, double x, double width) {
+	return repairVal(f.scalar, x, width);
+}
+
+/**
+ * Calculates a function's value at a block of points.
+ * With the deferredRepair policy, any point which is a singularity is then
+ * repaired by repairVal(), and the block is only checked once when none are.
+ * @param f the function to find the values of (a batchFunction or a callable)
+ * @param x the points to find the values at
+ * @param [out] fx the values of f at x
+ * @param n the number of points
+ * @param width the "width" to consider as close to a point.
+ */
+template<typename Policy = deferredRepair, typename Function>
+inline void findVals(const Function &f, const double *x, double *fx, int n,
+      double width) {
+	evaluate(f, x, fx, n);
+	if (!Policy::repair)
+		return;
+	bool singular = false;
+	for (int i = 0; i < n; i++) {
+		singular |= !(fabs(fx[i]) <= DBL_MAX); // true for inf and NaN
+	}
+	if (!singular)
+		return;
+	for (int i = 0; i < n; i++) {
+		if (isnan(fx[i]) || isinf(fx[i]))
+			fx[i] = repairVal(f, x[i], width);
+	}
+}
+
+/**
+ * Calculates a function's value at a single point, as findVal() does
+ * @param f the function to find the value of
+ * @param x the point to find the value at
+ * @param width the "width" to consider as close to the point.
+ * @return the value of f at x
+ */
+inline double findVal(const batchFunction &f, double x, double width) {
+	double val;
+	findVals(f, &x, &val, 1, width);
+	return val;
+}
+
+/**
+ * Sums the weighted values of a composite rule over panels first to last-1,
+ * where panel j runs from a + j * width to a + (j + 1) * width and contains
+ * the points a + (j + nodes[k]) * width. Whole panels are evaluated together,
+ * up to BATCH_SIZE points at a time.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param width the width of each panel
+ * @param first the first panel to sum
+ * @param last one past the last panel to sum
+ * @param nodes the points in each panel, as fractions of width
+ * @param weights the weight of each point
+ * @return the weighted sum
+ */
+template<typename Policy, typename Function, size_t P>
+double panelSum(const Function &f, double a, double width, long first,
+      long last, const std::array<double, P> &nodes,
+      const std::array<double, P> &weights) {
+	const int panels = BATCH_SIZE / P > 0 ? BATCH_SIZE / P : 1; // per block
+	double x[panels * P];
+	double fx[panels * P];
+	double sum = 0;
+	for (long j = first; j < last; j += panels) {
+		int count = (int) std::min<long>(panels, last - j);
+		for (int p = 0; p < count; p++) {
+			for (size_t k = 0; k < P; k++) {
+				x[p * P + k] = a + (j + p + nodes[k]) * width;
+			}
+		}
+		findVals<Policy>(f, x, fx, count * P, width);
+		for (int p = 0; p < count; p++) {
+			for (size_t k = 0; k < P; k++) {
+				sum += weights[k] * fx[p * P + k];
+			}
+		}
+	}
+	return sum;
+}
+
+/**
+ * Sums the weighted values of a function at a few points, evaluated together
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param x the points
+ * @param weights the weight of each point
+ * @param width the "width" to consider as close to a point.
+ * @return the weighted sum
+ */
+template<typename Policy, typename Function, size_t N>
+double weightedSum(const Function &f, const std::array<double, N> &x,
+      const std::array<double, N> &weights, double width) {
+	double fx[N];
+	findVals<Policy>(f, x.data(), fx, N, width);
+	double sum = 0;
+	for (size_t i = 0; i < N; i++) {
+		sum += weights[i] * fx[i];
+	}
+	return sum;
+}
+
+#endif /* BATCHFUNCTION_H_ */
@@ -1,37 +1,117 @@
 /**
  * @file FindVal.h
- * @brief Allows for calculation of a gsl_function at a point
+ * @brief Allows for calculation of a gsl_function (or any callable) at a point
  * @author Irene Crowell
  */
 #ifndef FINDVAL_H_
 #define FINDVAL_H_
 #include <gsl/gsl_math.h>
 #include <iostream>
+#include <type_traits>
+#include <atomic>
+/**
+ * Enables a template only for callables which take a double and return the
+ * value of a function there (lambdas, function objects and function pointers)
+ */
+template<typename Function>
+using ifIntegrand = typename std::enable_if<
+      std::is_invocable_r<double, const Function&, double>::value, int>::type;
+
+/**
+ * How far either side of a singularity findVal() looks, relative to the width
+ */
+const double REPAIR_OFFSET = 0.001;
+
+/**
+ * Counts, across all threads, the values findVal() has had to repair
+ */
+struct repairStatistics {
+	std::atomic<long> repaired { 0 }; //!<the number of values which were not finite
+	std::atomic<long> evaluations { 0 }; //!<the extra evaluations made to repair them
+
+	/**
+	 * @return the counts shared by every thread
+	 */
+	static repairStatistics &getInstance() {
+		static repairStatistics statistics;
+		return statistics;
+	}
+	/**
+	 * Sets both counts to 0
+	 */
+	void reset() {
+		repaired = 0;
+		evaluations = 0;
+	}
+};
+
+/**
+ * Replaces a function's value at a singularity by averaging points nearby
+ * (relative to the width), or extrapolating from one side if the other is
+ * also singular.
+ * @param f the function, called as f(x)
+ * @param x the point where f is not finite
+ * @param width the "width" to consider as close to the point.
+ * @return the repaired value of f at x
+ */
+template<typename Function, ifIntegrand<Function> = 0>
+double repairVal(const Function &f, double x, double width) {
+	double val;
+	long evaluations = 2;
+	double fa = f(x - REPAIR_OFFSET * width);
+	double fb = f(x + REPAIR_OFFSET * width);
+	if (isnan(fa) || isinf(fa)) {
+		double fm = f(x + 0.5 * REPAIR_OFFSET * width);
+		val = 2 * fm - fb; //same as fm-(fb-fm) -> linear guess at value of f(x)
+		evaluations++;
+	} else if (isnan(fb) || isinf(fb)) {
+		double fm = f(x - 0.5 * REPAIR_OFFSET * width);
+		val = 2 * fm - fa; //same as fm-(fa-fm) -> linear guess at value of f(x)
+		evaluations++;
+	} else {
+		val = (fa + fb) / 2.0;
+	}
+	repairStatistics &statistics = repairStatistics::getInstance();
+	statistics.repaired.fetch_add(1, std::memory_order_relaxed);
+	statistics.evaluations.fetch_add(evaluations, std::memory_order_relaxed);
+	return val;
+}
+/**
+ * Replaces a gsl_function's value at a singularity, as repairVal() does for callables
+ * @param f the function
+ * @param x the point where f is not finite
+ * @param width the "width" to consider as close to the point.
+ * @return the repaired value of f at x
+ */
+inline double repairVal(gsl_function f, double x, double width) {
+	return repairVal([&f](double x) {return f.function(x, f.params);}, x,
+	      width);
+}
+
 /**
  * Calculates a function's value at a point.
- * If the point is a singularity, it averages points nearby (relative to the width).
+ * If the point is a singularity, it is repaired by repairVal().
+ * @param f the function to find the value of, called as f(x)
+ * @param x the point to find the value at
+ * @param width the "width" to consider as close to the point.
+ * @return the value of f at x
+ */
+template<typename Function, ifIntegrand<Function> = 0>
+inline double findVal(const Function &f, double x, double width) {
+	double val = f(x);
+	if (isnan(val) || isinf(val))
+		val = repairVal(f, x, width);
+	return val;
+}
+/**
+ * Calculates a gsl_function's value at a point, as findVal() does for callables
  * @param f the function to find the value of
  * @param x the point to find the value at
  * @param width the "width" to consider as close to the point.
  * @return the value of f at x
  */
 inline double findVal(gsl_function f, double x, double width) {
-	double* q = 0;
-	double val = f.function(x, q);
-	if (isnan(val) || isinf(val)) {
-		double fa = f.function(x - 0.001 * width, q);
-		double fb = f.function(x + 0.001 * width, q);
-		if (isnan(fa) || isinf(fa)) {
-			double fm = f.function(x + 0.0005 * width, q);
-			val = 2 * fm - fb; //same as fm-(fb-fm) -> linear guess at value of f(x)
-		} else if (isnan(fb) || isinf(fb)) {
-			double fm = f.function(x - 0.0005 * width, q);
-			val = 2 * fm - fa; //same as fm-(fa-fm) -> linear guess at value of f(x)
-		} else {
-			val = (fa + fb) / 2.0;
-		}
-	}
-	return val;
+	return findVal([&f](double x) {return f.function(x, f.params);}, x, width);
 }
 
 #endif /* FINDVAL_H_ */
@@ -0,0 +1,287 @@
+/**
+ * @file GlobalAdaptive.h
+ * @brief Contains the globally adaptive (error-prioritised) scheme shared by the Newton-Cotes rules
+ * Instead of accepting each interval against a local error test, the intervals are
+ * kept in a heap ordered by their error estimate, the worst one is always divided
+ * next, and the calculation stops once the summed error estimate meets the goal.
+ * @author Irene Crowell
+ */
+#ifndef GLOBALADAPTIVE_H_
+#define GLOBALADAPTIVE_H_
+#include <math.h>
+#include <float.h>
+#include <ctime>
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <gsl/gsl_math.h>
+#include "../ThreadPool.h"
+#include "BatchFunction.h"
+
+namespace GlobalAdaptive {
+/**
+ * The most segments a thread of parallel() takes from the shared heap at once (it
+ * takes fewer when there are not enough for every thread), so the threads lock the
+ * heap less often
+ */
+const int SEGMENT_BATCH = 4;
+
+/**
+ * An interval divided twice, with the error of its integral estimated by
+ * comparing the integral of the whole to the sum of its halves
+ */
+template<typename LeftRight>
+struct segment {
+	LeftRight left; //!<the left half, integrated and divided
+	LeftRight right; //!<the right half, integrated and divided
+	double value; //!<the integral of the interval
+	double error; //!<the estimated error of value
+	/**
+	 * Orders segments by error, so the heap's top is the worst segment
+	 * @param other the segment to compare with
+	 * @return true if this segment has the smaller error
+	 */
+	bool operator<(const segment &other) const {
+		return error < other.error;
+	}
+	/**
+	 * @return the width of the interval
+	 */
+	double width() const {
+		return right.right.b - left.left.a;
+	}
+};
+
+/**
+ * Integrates both halves of an already divided interval and estimates the error.
+ * The difference of the halves and the whole, over the Richardson constant, is the
+ * error of the halves only when the function is smooth enough for the rule's error
+ * term, so an extrapolated value is given the whole difference as its error.
+ * @param whole the interval, integrated and divided
+ * @param getLeftRight the rule's function to integrate and divide an interval
+ * @param f the function to integrate
+ * @param richardson the rule's Richardson constant ((4^n)-1)
+ * @param extrapolate whether to apply Richardson extrapolation to the value
+ * @return the segment
+ */
+template<typename Interval, typename LeftRight, typename Function>
+segment<LeftRight> makeSegment(const LeftRight &whole,
+      LeftRight (*getLeftRight)(Interval, const Function &),
+      const Function &f, double richardson, bool extrapolate) {
+	segment<LeftRight> s;
+	s.left = getLeftRight(whole.left, f);
+	s.right = getLeftRight(whole.right, f);
+	double fine = s.left.integrated + s.right.integrated;
+	double difference = fine - whole.integrated;
+	s.error = extrapolate ? fabs(difference) : fabs(difference) / richardson;
+	s.value = extrapolate ? fine + difference / richardson : fine;
+	return s;
+}
+
+/**
+ * Calculates the numerical integral, always dividing the interval with the
+ * largest error estimate until the summed estimate meets the error goal.
+ * @param whole the whole interval, integrated and divided
+ * @param getLeftRight the rule's function to integrate and divide an interval
+ * @param f the function to integrate
+ * @param richardson the rule's Richardson constant ((4^n)-1)
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Interval, typename LeftRight, typename Function>
+double nonParallel(const LeftRight &whole,
+      LeftRight (*getLeftRight)(Interval, const Function &),
+      const Function &f, double richardson, double error,
+      int max_subdivisions, int max_time, bool extrapolate, int *subdivisions,
+      double *abserror) {
+	std::clock_t start = std::clock();
+	std::priority_queue<segment<LeftRight>> intervals;
+	segment<LeftRight> first = makeSegment(whole, getLeftRight, f, richardson,
+	      extrapolate);
+	double min_width = first.width() * DBL_EPSILON; // narrower intervals are not divided
+	double total_error = first.error;
+	double result = 0; // the intervals too narrow to divide
+	double result_error = 0;
+	intervals.push(first);
+	(*subdivisions) = 1;
+
+	while (!intervals.empty() && total_error > error
+	      && (*subdivisions) < max_subdivisions
+	      && ((std::clock() - start) / (double) CLOCKS_PER_SEC) <= max_time) {
+		segment<LeftRight> worst = intervals.top();
+		intervals.pop();
+		if (worst.width() < min_width) {
+			result += worst.value;
+			result_error += worst.error;
+			continue;
+		}
+		segment<LeftRight> left = makeSegment(worst.left, getLeftRight, f,
+		      richardson, extrapolate);
+		segment<LeftRight> right = makeSegment(worst.right, getLeftRight, f,
+		      richardson, extrapolate);
+		total_error += left.error + right.error - worst.error;
+		intervals.push(left);
+		intervals.push(right);
+		(*subdivisions)++;
+	}
+	while (!intervals.empty()) { // sum afresh, rather than trusting the running total
+		result += intervals.top().value;
+		result_error += intervals.top().error;
+		intervals.pop();
+	}
+	(*abserror) = result_error;
+	return result;
+}
+
+/**
+ * The heap and totals shared by the threads of parallel()
+ */
+template<typename LeftRight>
+struct sharedHeap {
+	std::mutex mutex; //!<guards every member
+	std::condition_variable changed; //!<signalled when intervals or in_flight change
+	std::priority_queue<segment<LeftRight>> intervals; //!<the intervals, worst first
+	int in_flight = 0; //!<the number of intervals being divided by a thread
+	double total_error = 0; //!<the summed error estimate, including intervals in flight or too narrow to divide
+	double result = 0; //!<the sum of the intervals too narrow to divide
+	double result_error = 0; //!<the summed error of the intervals too narrow to divide
+	int subdivisions = 1; //!<the number of subdivisions used
+};
+
+/**
+ * For threading -- repeatedly takes the intervals with the largest error
+ * estimates from the shared heap (up to SEGMENT_BATCH at a time), divides them,
+ * and returns their halves.
+ * Stops once the error goal or a limit is reached, or no interval can be divided.
+ * A thread which leaves intervals in the heap wakes one waiting thread, which
+ * passes the wake on in turn, so threads are only woken when there is work.
+ * @param getLeftRight the rule's function to integrate and divide an interval
+ * @param f the function to integrate
+ * @param richardson the rule's Richardson constant ((4^n)-1)
+ * @param num_threads the number of parallel threads running
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param min_width the narrowest interval to divide further
+ * @param heap pointer to the shared heap of intervals
+ */
+template<typename Interval, typename LeftRight, typename Function>
+void parallelThread(LeftRight (*getLeftRight)(Interval, const Function &),
+      const Function &f, double richardson, int num_threads, double error,
+      int max_subdivisions, int max_time, bool extrapolate, double min_width,
+      sharedHeap<LeftRight> *heap) {
+	std::clock_t start = std::clock();
+	std::vector<segment<LeftRight>> batch;
+	std::vector<segment<LeftRight>> halves;
+	std::unique_lock<std::mutex> lock(heap->mutex);
+	while (true) {
+		bool done = heap->total_error <= error
+		      || heap->subdivisions >= max_subdivisions
+		      || ((std::clock() - start) / (double) CLOCKS_PER_SEC) > max_time;
+		if (done || (heap->intervals.empty() && heap->in_flight == 0))
+			break;
+		if (heap->intervals.empty()) { // wait for a thread to return its halves
+			heap->changed.wait(lock);
+			continue;
+		}
+		// a share of the worst intervals, leaving some for the other threads
+		size_t share = std::max<size_t>(1, std::min<size_t>(SEGMENT_BATCH,
+		      heap->intervals.size() / num_threads));
+		batch.clear();
+		while (batch.size() < share && !heap->intervals.empty()
+		      && heap->subdivisions < max_subdivisions) {
+			segment<LeftRight> worst = heap->intervals.top();
+			heap->intervals.pop();
+			if (worst.width() < min_width) { // its error stays in total_error, as in nonParallel()
+				heap->result += worst.value;
+				heap->result_error += worst.error;
+				continue;
+			}
+			batch.push_back(worst);
+			heap->subdivisions++;
+		}
+		if (batch.empty())
+			continue;
+		heap->in_flight += batch.size();
+		if (!heap->intervals.empty())
+			heap->changed.notify_one();
+		lock.unlock();
+
+		halves.clear();
+		for (const segment<LeftRight> &worst : batch) {
+			halves.push_back(makeSegment(worst.left, getLeftRight, f, richardson,
+			      extrapolate));
+			halves.push_back(makeSegment(worst.right, getLeftRight, f,
+			      richardson, extrapolate));
+		}
+
+		lock.lock();
+		for (size_t i = 0; i < batch.size(); i++) {
+			heap->total_error += halves[2 * i].error + halves[2 * i + 1].error
+			      - batch[i].error;
+			heap->intervals.push(halves[2 * i]);
+			heap->intervals.push(halves[2 * i + 1]);
+		}
+		heap->in_flight -= batch.size();
+		heap->changed.notify_one();
+	}
+	heap->changed.notify_all(); // let waiting threads see that we are done
+}
+
+/**
+ * Calculates using parallel threads the numerical integral, dividing the
+ * intervals with the largest error estimates until the summed estimate meets
+ * the error goal.
+ * @param whole the whole interval, integrated and divided
+ * @param getLeftRight the rule's function to integrate and divide an interval
+ * @param f the function to integrate
+ * @param richardson the rule's Richardson constant ((4^n)-1)
+ * @param num_threads the number of parallel threads to run
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Interval, typename LeftRight, typename Function>
+double parallel(const LeftRight &whole,
+      LeftRight (*getLeftRight)(Interval, const Function &),
+      const Function &f, double richardson, int num_threads, double error,
+      int max_subdivisions, int max_time, bool extrapolate, int *subdivisions,
+      double *abserror) {
+	sharedHeap<LeftRight> heap;
+	segment<LeftRight> first = makeSegment(whole, getLeftRight, f, richardson,
+	      extrapolate);
+	double min_width = first.width() * DBL_EPSILON; // narrower intervals are not divided
+	heap.total_error = first.error;
+	heap.intervals.push(first);
+
+	ThreadPool::getInstance().run(num_threads, [&](int) {
+		parallelThread(getLeftRight, f, richardson, num_threads, error,
+		      max_subdivisions, max_time, extrapolate, min_width, &heap);
+	});
+
+	double result = heap.result;
+	double result_error = heap.result_error;
+	while (!heap.intervals.empty()) {
+		result += heap.intervals.top().value;
+		result_error += heap.intervals.top().error;
+		heap.intervals.pop();
+	}
+	(*subdivisions) = heap.subdivisions;
+	(*abserror) = result_error;
+	return result;
+}
+}
+
+#endif /* GLOBALADAPTIVE_H_ */
@@ -0,0 +1,1583 @@
+/**
+ * @file NewtonCotes.h
+ * @brief Contains the composite and adaptive schemes shared by the Newton-Cotes rules
+ * Each rule is described by a struct of constants, and every scheme is written once
+ * as a template on that description. A description contains:
+ * - GRID, the number of equal steps the points of the rule are placed on
+ * - nodes, the points of the rule, in steps from the left end (0 to GRID)
+ * - weights, the weight of each node, and divisor, so the integral of an
+ *   interval is width * (sum of weight * f(node)) / divisor
+ * - stored, the points whose values an interval keeps for its halves (each must be
+ *   an even step, so it is also a point of the enclosing interval)
+ * - richardson, the constant ((4^n)-1) dividing the difference of an interval and
+ *   its halves in the error estimate
+ * - order, the power of the width the composite rule's error falls with, for its
+ *   error estimate
+ *
+ * The schemes are also templated on the function, which is either a batchFunction or
+ * any callable taking a double (see findVals()). A callable is called directly, so
+ * each instantiation can inline it into the rule's loops. Lastly, they are templated
+ * on the evaluation policy (unchecked or deferredRepair), so functions which are
+ * known to be finite skip the checks for singularities entirely.
+ * @author Irene Crowell
+ */
+#ifndef NEWTONCOTES_H_
+#define NEWTONCOTES_H_
+#include <math.h>
+#include <float.h>
+#include <ctime>
+#include <array>
+#include <queue>
+#include <vector>
+#include <atomic>
+#include <numeric>
+#include <algorithm>
+#include "BatchFunction.h"
+#include "GlobalAdaptive.h"
+#include "../ThreadPool.h"
+#include "../Frontier.h"
+#include "../PartialSum.h"
+#include "../Partition.h"
+#include "../AdvancedRules/Extrapolation.h"
+
+namespace NewtonCotes {
+/**
+ * A simple section to integrate
+ */
+template<typename Rule>
+struct interval {
+	double a; //!<the left (starting) point
+	double b; //!<the right (ending) point
+	std::array<double, Rule::stored.size()> f; //!<the values of the function at the rule's stored points
+};
+/**
+ * An already integrated section divided in two
+ */
+template<typename Rule>
+struct leftRightInterval {
+	interval<Rule> left; //!<the left half of the interval
+	interval<Rule> right; //!<the right half of the interval
+	double integrated; //!<the calculated integral of the interval, for estimating error in adaptive rules
+};
+/**
+ * An integrated section which keeps the value at every node of the rule, for the
+ * nested adaptive schemes
+ */
+template<typename Rule>
+struct nestedInterval {
+	double a; //!<the left (starting) point
+	double b; //!<the right (ending) point
+	double integrated; //!<the calculated integral of the interval, found when its parent is divided (see splitNested())
+	std::array<double, Rule::nodes.size()> f; //!<the values of the function at the rule's nodes, as found (they may not be finite)
+};
+
+/**
+ * @param p a step of the grid
+ * @return true if an interval stores the value at p
+ */
+template<typename Rule>
+constexpr bool isStored(int p) {
+	for (int s : Rule::stored) {
+		if (s == p)
+			return true;
+	}
+	return false;
+}
+/**
+ * @param p a step of the grid
+ * @return true if getLeftRight() needs the value at p, for the rule or for either half
+ */
+template<typename Rule>
+constexpr bool isNeeded(int p) {
+	for (int node : Rule::nodes) {
+		if (node == p)
+			return true;
+	}
+	for (int s : Rule::stored) {
+		if (s / 2 == p || Rule::GRID / 2 + s / 2 == p)
+			return true;
+	}
+	return false;
+}
+/**
+ * @return the number of points getLeftRight() evaluates
+ */
+template<typename Rule>
+constexpr int countNew() {
+	int count = 0;
+	for (int p = 0; p <= Rule::GRID; p++) {
+		if (isNeeded<Rule>(p) && !isStored<Rule>(p))
+			count++;
+	}
+	return count;
+}
+/**
+ * @return the steps of the grid getLeftRight() evaluates
+ */
+template<typename Rule>
+constexpr std::array<int, countNew<Rule>()> newPoints() {
+	std::array<int, countNew<Rule>()> points { };
+	int count = 0;
+	for (int p = 0; p <= Rule::GRID; p++) {
+		if (isNeeded<Rule>(p) && !isStored<Rule>(p))
+			points[count++] = p;
+	}
+	return points;
+}
+/**
+ * @param p a step of the grid of the halves (twice as fine as the interval's)
+ * @return true if p is a node of either half, but not a node of the interval
+ */
+template<typename Rule>
+constexpr bool isNestedNew(int p) {
+	bool half_node = false;
+	bool node = false;
+	for (int n : Rule::nodes) {
+		half_node |= (n == p || Rule::GRID + n == p);
+		node |= (2 * n == p);
+	}
+	return half_node && !node;
+}
+/**
+ * @return the number of points splitNested() evaluates
+ */
+template<typename Rule>
+constexpr int countNested() {
+	int count = 0;
+	for (int p = 0; p <= 2 * Rule::GRID; p++) {
+		if (isNestedNew<Rule>(p))
+			count++;
+	}
+	return count;
+}
+/**
+ * @return the steps of the halves' grid splitNested() evaluates
+ */
+template<typename Rule>
+constexpr std::array<int, countNested<Rule>()> nestedPoints() {
+	std::array<int, countNested<Rule>()> points { };
+	int count = 0;
+	for (int p = 0; p <= 2 * Rule::GRID; p++) {
+		if (isNestedNew<Rule>(p))
+			points[count++] = p;
+	}
+	return points;
+}
+/**
+ * @return true if the rule's first and last nodes are the ends of the interval,
+ * so neighbouring subdivisions of the composite rule share them
+ */
+template<typename Rule>
+constexpr bool sharedEnds() {
+	return Rule::nodes.front() == 0 && Rule::nodes.back() == Rule::GRID;
+}
+/**
+ * @return the number of points in each subdivision of the composite rule
+ */
+template<typename Rule>
+constexpr size_t panelSize() {
+	return sharedEnds<Rule>() ? Rule::nodes.size() - 1 : Rule::nodes.size();
+}
+/**
+ * @return the points in each subdivision of the composite rule, as fractions of
+ * its width (with shared ends, the left end belongs to the previous subdivision)
+ */
+template<typename Rule>
+constexpr std::array<double, panelSize<Rule>()> panelNodes() {
+	std::array<double, panelSize<Rule>()> nodes { };
+	size_t first = Rule::nodes.size() - panelSize<Rule>();
+	for (size_t k = 0; k < nodes.size(); k++) {
+		nodes[k] = Rule::nodes[first + k] / (double) Rule::GRID;
+	}
+	return nodes;
+}
+/**
+ * @return the weight of each of panelNodes() (a shared end has the weight of both)
+ */
+template<typename Rule>
+constexpr std::array<double, panelSize<Rule>()> panelWeights() {
+	std::array<double, panelSize<Rule>()> weights { };
+	size_t first = Rule::nodes.size() - panelSize<Rule>();
+	for (size_t k = 0; k < weights.size(); k++) {
+		weights[k] = Rule::weights[first + k];
+	}
+	if (sharedEnds<Rule>())
+		weights[weights.size() - 1] += Rule::weights[0];
+	return weights;
+}
+
+/**
+ * Creates the whole interval, finding the values at its stored points
+ * @param f the function to integrate
+ * @param a the left (starting) point
+ * @param b the right (ending) point
+ * @return the interval
+ */
+template<typename Rule, typename Policy, typename Function>
+interval<Rule> wholeInterval(const Function &f, double a, double b) {
+	interval<Rule> whole { a, b, { } };
+	std::array<double, Rule::stored.size()> x;
+	for (size_t i = 0; i < x.size(); i++) {
+		x[i] = a + (b - a) * Rule::stored[i] / Rule::GRID;
+	}
+	findVals<Policy>(f, x.data(), whole.f.data(), x.size(), b - a);
+	return whole;
+}
+
+/**
+ * Integrates and divides an interval into two, resulting in a leftRightInterval (for adaptive rules)
+ * @param currentInterval the interval to integrate and divide
+ * @param f the function to integrate
+ * @return the divided and integrated interval
+ */
+template<typename Rule, typename Policy, typename Function>
+leftRightInterval<Rule> getLeftRight(interval<Rule> currentInterval,
+      const Function &f) {
+	static_assert(Rule::GRID % 2 == 0, "the midpoint must be on the grid");
+	constexpr std::array<int, countNew<Rule>()> points = newPoints<Rule>();
+	double width = currentInterval.b - currentInterval.a;
+	double values[Rule::GRID + 1]; // the function at each step of the grid
+	for (size_t i = 0; i < Rule::stored.size(); i++) {
+		values[Rule::stored[i]] = currentInterval.f[i];
+	}
+	double x[points.size()];
+	double fx[points.size()];
+	for (size_t i = 0; i < points.size(); i++) {
+		x[i] = currentInterval.a + width * points[i] / Rule::GRID;
+	}
+	findVals<Policy>(f, x, fx, points.size(), width);
+	for (size_t i = 0; i < points.size(); i++) {
+		values[points[i]] = fx[i];
+	}
+
+	double integrate = 0;
+	for (size_t k = 0; k < Rule::nodes.size(); k++) {
+		integrate += Rule::weights[k] * values[Rule::nodes[k]];
+	}
+	double m = (currentInterval.a + currentInterval.b) / 2;
+	leftRightInterval<Rule> divided { { currentInterval.a, m, { } }, { m,
+	      currentInterval.b, { } }, integrate * width / Rule::divisor };
+	for (size_t i = 0; i < Rule::stored.size(); i++) {
+		divided.left.f[i] = values[Rule::stored[i] / 2];
+		divided.right.f[i] = values[Rule::GRID / 2 + Rule::stored[i] / 2];
+	}
+	return divided;
+}
+
+/**
+ * Sums the weighted values at a, and at the points of the last subdivision, which
+ * are not in the composite rule's panelSum() (for rules with shared ends)
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param width the size of each subdivision
+ * @return the weighted sum
+ */
+template<typename Rule, typename Policy, typename Function>
+double endSum(const Function &f, double a, double b, double width) {
+	if (!sharedEnds<Rule>())
+		return 0;
+	std::array<double, Rule::nodes.size()> x;
+	std::array<double, Rule::nodes.size()> weights;
+	x[0] = a;
+	weights[0] = Rule::weights[0];
+	for (size_t k = 1; k < x.size(); k++) {
+		x[k] = b - width + width * Rule::nodes[k] / Rule::GRID;
+		weights[k] = Rule::weights[k];
+	}
+	return weightedSum<Policy>(f, x, weights, width);
+}
+/**
+ * @param subdivisions the number of subdivisions
+ * @return the number of subdivisions summed by panelSum() (all but the last,
+ * for rules with shared ends)
+ */
+template<typename Rule>
+long panelCount(int subdivisions) {
+	return sharedEnds<Rule>() ? subdivisions - 1 : subdivisions;
+}
+
+/**
+ * Calculates the numerical integral using the composite rule
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double nonAdaptiveNonParallel(const Function &f, double a, double b,
+      int subdivisions) {
+	double width = (b - a) / subdivisions;
+
+	double result = endSum<Rule, Policy>(f, a, b, width);
+	result += panelSum<Policy>(f, a, width, 0, panelCount<Rule>(subdivisions),
+	      panelNodes<Rule>(), panelWeights<Rule>());
+	return result * width / Rule::divisor;
+}
+/**
+ * For threading -- calculates a section of the integral using the composite rule
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision
+ * @param first the first subdivision of this thread's section
+ * @param last one past the last subdivision of this thread's section
+ * @param [out] partial this thread's sum of the numerical integral sections
+ */
+template<typename Rule, typename Policy, typename Function>
+void nonAdaptiveThread(const Function &f, double a, double width,
+      long first, long last, partialSum *partial) {
+	partial->value = panelSum<Policy>(f, a, width, first, last,
+	      panelNodes<Rule>(), panelWeights<Rule>());
+	partial->evaluations = panelSize<Rule>() * (last - first);
+}
+/**
+ * Calculates using parallel sections the integral using the composite rule
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double nonAdaptiveParallel(const Function &f, double a, double b,
+      int subdivisions, int num_threads) {
+	std::vector<partialSum> partials(num_threads);
+	double width = (b - a) / subdivisions;
+	long panels = panelCount<Rule>(subdivisions);
+
+	double result = endSum<Rule, Policy>(f, a, b, width);
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		nonAdaptiveThread<Rule, Policy>(f, a, width, panels * i / num_threads,
+		      panels * (i + 1) / num_threads, &partials[i]);
+	});
+	result += sumPartials(partials).value;
+	return result * width / Rule::divisor;
+}
+
+/**
+ * @return the number of subdivisions grouped for the error estimate of the
+ * composite rule: the fewest (2 or 3) for which the rule on the whole group only
+ * uses points of the rule on each subdivision, or 0 if there are none
+ */
+template<typename Rule>
+constexpr int groupSize() {
+	for (int r = 2; r <= 3; r++) {
+		bool nested = true;
+		for (int n : Rule::nodes) {
+			bool found = false;
+			for (int j = 0; j < r; j++) {
+				for (int m : Rule::nodes) {
+					found |= (j * Rule::GRID + m == r * n);
+				}
+			}
+			nested &= found;
+		}
+		if (nested)
+			return r;
+	}
+	return 0;
+}
+/**
+ * @param s a step of a group's grid (groupSize() times the rule's)
+ * @return true if s is a point of the rule on one of the group's subdivisions
+ */
+template<typename Rule>
+constexpr bool isGroupNode(int s) {
+	for (int j = 0; j < groupSize<Rule>(); j++) {
+		for (int m : Rule::nodes) {
+			if (j * Rule::GRID + m == s)
+				return true;
+		}
+	}
+	return false;
+}
+/**
+ * @return the number of points groupSum() evaluates for each group (with shared
+ * ends, the left end is the previous group's right end)
+ */
+template<typename Rule>
+constexpr int countGroup() {
+	int count = 0;
+	for (int s = sharedEnds<Rule>() ? 1 : 0;
+	      s <= groupSize<Rule>() * Rule::GRID; s++) {
+		if (isGroupNode<Rule>(s))
+			count++;
+	}
+	return count;
+}
+/**
+ * @return the steps of a group's grid groupSum() evaluates
+ */
+template<typename Rule>
+constexpr std::array<int, countGroup<Rule>()> groupPoints() {
+	std::array<int, countGroup<Rule>()> points { };
+	int count = 0;
+	for (int s = sharedEnds<Rule>() ? 1 : 0;
+	      s <= groupSize<Rule>() * Rule::GRID; s++) {
+		if (isGroupNode<Rule>(s))
+			points[count++] = s;
+	}
+	return points;
+}
+/**
+ * @param coarse true for the rule on the whole group, false for the composite rule
+ * on its subdivisions
+ * @return the weight of each step of a group's grid, in units of the subdivisions'
+ * width / divisor
+ */
+template<typename Rule>
+constexpr std::array<double, groupSize<Rule>() * Rule::GRID + 1> groupWeights(
+      bool coarse) {
+	std::array<double, groupSize<Rule>() * Rule::GRID + 1> weights { };
+	for (size_t k = 0; k < Rule::nodes.size(); k++) {
+		if (coarse) {
+			weights[groupSize<Rule>() * Rule::nodes[k]] += groupSize<Rule>()
+			      * Rule::weights[k];
+		} else {
+			for (int j = 0; j < groupSize<Rule>(); j++) {
+				weights[j * Rule::GRID + Rule::nodes[k]] += Rule::weights[k];
+			}
+		}
+	}
+	return weights;
+}
+
+/**
+ * Sums the weighted values of the composite rule over groups first to last-1, each
+ * of groupSize() subdivisions, and the differences from the rule on each whole
+ * group, using the same values. With shared ends, each group keeps its right end
+ * for the next group, so only the first group's left end is evaluated again.
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision
+ * @param first the first group to sum
+ * @param last one past the last group to sum
+ * @param [out] difference the sum of the groups' absolute differences
+ * @param [out] worst the largest of the groups' absolute differences
+ * @return the weighted sum
+ */
+template<typename Rule, typename Policy, typename Function>
+double groupSum(const Function &f, double a, double width, long first,
+      long last, double *difference, double *worst) {
+	constexpr int r = groupSize<Rule>();
+	static_assert(r > 0, "the rule must nest in a group of 2 or 3");
+	constexpr std::array<int, countGroup<Rule>()> points = groupPoints<Rule>();
+	constexpr std::array<double, r * Rule::GRID + 1> fine = groupWeights<Rule>(
+	      false);
+	constexpr std::array<double, r * Rule::GRID + 1> coarse = groupWeights<Rule>(
+	      true);
+	constexpr int P = points.size();
+	const int groups = BATCH_SIZE / P > 0 ? BATCH_SIZE / P : 1; // per block
+	double x[groups * P];
+	double fx[groups * P];
+	double sum = 0;
+	(*difference) = 0;
+	(*worst) = 0;
+	if (first >= last)
+		return 0;
+	double left = 0; // the value at the left end of the group (with shared ends)
+	if (sharedEnds<Rule>()) {
+		double end = a + first * r * width;
+		findVals<Policy>(f, &end, &left, 1, width);
+	}
+	for (long g = first; g < last; g += groups) {
+		int count = (int) std::min<long>(groups, last - g);
+		for (int p = 0; p < count; p++) {
+			for (int k = 0; k < P; k++) {
+				x[p * P + k] = a + ((g + p) * r + points[k] / (double) Rule::GRID)
+				      * width;
+			}
+		}
+		findVals<Policy>(f, x, fx, count * P, width);
+		for (int p = 0; p < count; p++) {
+			double value = fine[0] * left;
+			double change = (fine[0] - coarse[0]) * left;
+			for (int k = 0; k < P; k++) {
+				value += fine[points[k]] * fx[p * P + k];
+				change += (fine[points[k]] - coarse[points[k]]) * fx[p * P + k];
+			}
+			if (sharedEnds<Rule>())
+				left = fx[p * P + P - 1];
+			sum += value;
+			(*difference) += fabs(change);
+			(*worst) = std::max((*worst), fabs(change));
+		}
+	}
+	return sum;
+}
+/**
+ * Finds the difference of the group made of the last groupSize() subdivisions, which
+ * overlaps the last whole group, so that the subdivisions left over from the
+ * groups are also covered by the error estimate
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision
+ * @param subdivisions the number of subdivisions
+ * @return the absolute difference, or 0 if none are left over
+ */
+template<typename Rule, typename Policy, typename Function>
+double tailDifference(const Function &f, double a, double width,
+      int subdivisions) {
+	constexpr int r = groupSize<Rule>();
+	if (subdivisions % r == 0 || subdivisions < r)
+		return 0;
+	double difference;
+	double worst;
+	groupSum<Rule, Policy>(f, a + (subdivisions - r) * width, width, 0, 1,
+	      &difference, &worst);
+	return difference;
+}
+/**
+ * Converts the groups' differences into the error estimate of the composite rule.
+ * Richardson Extrapolation takes the error of the subdivisions as 1/(r^order-1) of
+ * their difference from the whole group, which assumes the function is smooth
+ * enough on each group for the rule's leading error term to dominate. Near a
+ * singularity or discontinuity it is not, and that group's error can be as large as
+ * its difference, so the estimate is never less than the largest group's
+ * difference. For a smooth function this only matters with fewer than about
+ * r^order groups.
+ * @param difference the sum of the groups' absolute differences (including
+ * tailDifference())
+ * @param worst the largest group's absolute difference (including
+ * tailDifference())
+ * @param groups the number of groups
+ * @return the estimated error, or DBL_MAX if there were no groups
+ */
+template<typename Rule>
+double groupError(double difference, double worst, long groups) {
+	if (groups == 0)
+		return DBL_MAX;
+	constexpr int r = groupSize<Rule>();
+	return std::max(difference / (pow(r, Rule::order) - 1), worst);
+}
+
+/**
+ * Calculates the numerical integral using the composite rule, and estimates its
+ * error from the same values.
+ * The subdivisions are taken in groups of groupSize(), whose points include those
+ * of the rule on the whole group, so the difference between the two estimates the
+ * error without evaluating any other points. Subdivisions left over from the last
+ * group use the composite rule, and are covered by one more group of the last
+ * subdivisions (see tailDifference()). The estimate is asymptotic on smooth
+ * functions, and falls back on the largest group's difference (see groupError()).
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param [out] abserror the estimated error
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double nonAdaptiveNonParallel(const Function &f, double a, double b,
+      int subdivisions, double *abserror) {
+	constexpr int r = groupSize<Rule>();
+	double width = (b - a) / subdivisions;
+	long groups = subdivisions / r;
+	double difference;
+	double worst;
+	double result = groupSum<Rule, Policy>(f, a, width, 0, groups, &difference,
+	      &worst);
+	result *= width / Rule::divisor;
+	if (subdivisions > groups * r)
+		result += nonAdaptiveNonParallel<Rule, Policy>(f, a + groups * r * width,
+		      b, subdivisions - groups * r);
+	double tail = tailDifference<Rule, Policy>(f, a, width, subdivisions);
+	(*abserror) = groupError<Rule>((difference + tail) * width / Rule::divisor,
+	      std::max(worst, tail) * width / Rule::divisor, groups);
+	return result;
+}
+/**
+ * Calculates using parallel sections the integral using the composite rule, and
+ * estimates its error from the same values (see the non-parallel version)
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @param [out] abserror the estimated error
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double nonAdaptiveParallel(const Function &f, double a, double b,
+      int subdivisions, int num_threads, double *abserror) {
+	constexpr int r = groupSize<Rule>();
+	std::vector<partialSum> partials(num_threads);
+	std::vector<double> worst(num_threads);
+	double width = (b - a) / subdivisions;
+	long groups = subdivisions / r;
+
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		partials[i].value = groupSum<Rule, Policy>(f, a, width,
+		      groups * i / num_threads, groups * (i + 1) / num_threads,
+		      &partials[i].error, &worst[i]);
+	});
+	partialSum total = sumPartials(partials);
+	double result = total.value * width / Rule::divisor;
+	if (subdivisions > groups * r)
+		result += nonAdaptiveNonParallel<Rule, Policy>(f, a + groups * r * width,
+		      b, subdivisions - groups * r);
+	double tail = tailDifference<Rule, Policy>(f, a, width, subdivisions);
+	(*abserror) = groupError<Rule>((total.error + tail) * width / Rule::divisor,
+	      std::max(*std::max_element(worst.begin(), worst.end()), tail) * width
+	            / Rule::divisor, groups);
+	return result;
+}
+
+/**
+ * @return the number of steps of the grid shared by the rules in each subdivision
+ * (the least common multiple of their grids)
+ */
+template<typename... Rules>
+constexpr int fusedGrid() {
+	int grid = 1;
+	((grid = std::lcm(grid, Rules::GRID)), ...);
+	return grid;
+}
+/**
+ * Marks the steps of the shared grid holding one of a rule's panelNodes()
+ * @param [out] marks the steps of the shared grid, 0 to grid
+ * @param grid the number of steps of the shared grid
+ */
+template<typename Rule, size_t N>
+constexpr void markFused(std::array<bool, N> &marks, int grid) {
+	for (size_t k = Rule::nodes.size() - panelSize<Rule>(); k < Rule::nodes.size();
+	      k++) {
+		marks[Rule::nodes[k] * (grid / Rule::GRID)] = true;
+	}
+}
+/**
+ * @return the steps of the shared grid holding a point of any of the rules
+ */
+template<typename... Rules>
+constexpr std::array<bool, fusedGrid<Rules...>() + 1> fusedMarks() {
+	std::array<bool, fusedGrid<Rules...>() + 1> marks { };
+	(markFused<Rules>(marks, fusedGrid<Rules...>()), ...);
+	return marks;
+}
+/**
+ * @return the number of points fusedPanelSums() evaluates in each subdivision
+ */
+template<typename... Rules>
+constexpr int countFused() {
+	int count = 0;
+	for (bool mark : fusedMarks<Rules...>()) {
+		count += mark;
+	}
+	return count;
+}
+/**
+ * @return the steps of the shared grid fusedPanelSums() evaluates, in order
+ */
+template<typename... Rules>
+constexpr std::array<int, countFused<Rules...>()> fusedPoints() {
+	std::array<int, countFused<Rules...>()> points { };
+	int count = 0;
+	for (int s = 0; s <= fusedGrid<Rules...>(); s++) {
+		if (fusedMarks<Rules...>()[s])
+			points[count++] = s;
+	}
+	return points;
+}
+/**
+ * Adds a rule's weight at each of fusedPoints(), as in panelWeights() for every
+ * subdivision but the last, or for the last without the weights of the next
+ * subdivision's left end
+ * @param [out] weights the rule's weight at each point
+ * @param points the steps of the shared grid
+ * @param grid the number of steps of the shared grid
+ * @param last true for the last subdivision
+ */
+template<typename Rule, size_t P>
+constexpr void fusedRow(std::array<double, P> &weights,
+      const std::array<int, P> &points, int grid, bool last) {
+	for (size_t k = Rule::nodes.size() - panelSize<Rule>(); k < Rule::nodes.size();
+	      k++) {
+		for (size_t i = 0; i < P; i++) {
+			if (points[i] == Rule::nodes[k] * (grid / Rule::GRID))
+				weights[i] += Rule::weights[k];
+		}
+	}
+	if (sharedEnds<Rule>() && !last)
+		weights[P - 1] += Rule::weights[0];
+}
+/**
+ * @param last true for the weights of the last subdivision
+ * @return each rule's weight at each of fusedPoints()
+ */
+template<typename... Rules>
+constexpr std::array<std::array<double, countFused<Rules...>()>,
+      sizeof...(Rules)> fusedWeights(bool last) {
+	std::array<std::array<double, countFused<Rules...>()>, sizeof...(Rules)> weights { };
+	size_t r = 0;
+	(fusedRow<Rules>(weights[r++], fusedPoints<Rules...>(),
+	      fusedGrid<Rules...>(), last), ...);
+	return weights;
+}
+
+/**
+ * Sums the weighted values of several composite rules over subdivisions first to
+ * last-1, evaluating the function once at every point any of them uses, up to
+ * BATCH_SIZE points at a time, and applying each rule's weights to the same values
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision
+ * @param first the first subdivision to sum
+ * @param last one past the last subdivision to sum
+ * @param points the steps of the shared grid to evaluate (from fusedPoints())
+ * @param grid the number of steps of the shared grid in each subdivision
+ * @param weights each rule's weight at each point (from fusedWeights())
+ * @return each rule's weighted sum
+ */
+template<typename Policy, typename Function, size_t R, size_t P>
+std::array<double, R> fusedPanelSums(const Function &f, double a, double width,
+      long first, long last, const std::array<int, P> &points, int grid,
+      const std::array<std::array<double, P>, R> &weights) {
+	const int panels = BATCH_SIZE / P > 0 ? BATCH_SIZE / P : 1; // per block
+	double x[panels * P];
+	double fx[panels * P];
+	std::array<double, R> sums { };
+	for (long j = first; j < last; j += panels) {
+		int count = (int) std::min<long>(panels, last - j);
+		for (int p = 0; p < count; p++) {
+			for (size_t k = 0; k < P; k++) {
+				x[p * P + k] = a + (j + p + points[k] / (double) grid) * width;
+			}
+		}
+		findVals<Policy>(f, x, fx, count * P, width);
+		for (size_t r = 0; r < R; r++) {
+			double sum = 0;
+			for (int p = 0; p < count; p++) {
+				for (size_t k = 0; k < P; k++) {
+					sum += weights[r][k] * fx[p * P + k];
+				}
+			}
+			sums[r] += sum;
+		}
+	}
+	return sums;
+}
+/**
+ * Adds the weighted values at a, and at the points of the last subdivision, to
+ * each rule's sum, and converts the sums to integrals
+ * @param f the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param width the size of each subdivision
+ * @param sums each rule's sum over all but the last subdivision
+ * @return each rule's numerically integrated value
+ */
+template<typename Policy, typename... Rules, typename Function>
+std::array<double, sizeof...(Rules)> fusedEnds(const Function &f, double a,
+      double b, double width, std::array<double, sizeof...(Rules)> sums) {
+	constexpr std::array<int, countFused<Rules...>()> points = fusedPoints<
+	      Rules...>();
+	constexpr std::array<std::array<double, points.size()>, sizeof...(Rules)> weights =
+	      fusedWeights<Rules...>(true);
+	constexpr std::array<double, sizeof...(Rules)> left = { { (sharedEnds<Rules>() ?
+	      Rules::weights[0] : 0)... } };
+	constexpr std::array<double, sizeof...(Rules)> divisors = { { Rules::divisor... } };
+	std::array<double, sizeof...(Rules)> last = fusedPanelSums<Policy>(f,
+	      b - width, width, 0, 1, points, fusedGrid<Rules...>(), weights);
+	double fa;
+	findVals<Policy>(f, &a, &fa, 1, width);
+	for (size_t r = 0; r < sums.size(); r++) {
+		sums[r] = (sums[r] + last[r] + left[r] * fa) * width / divisors[r];
+	}
+	return sums;
+}
+
+/**
+ * Calculates the numerical integral using several composite rules at once.
+ * Their points are placed on one grid, which is evaluated once, so the rules
+ * together cost no more evaluations than the union of their points (the midpoint,
+ * trapezoid, Simpson's and Boole's rules together cost the same as Boole's).
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @return each rule's numerically integrated value, in the order of Rules
+ */
+template<typename Policy, typename... Rules, typename Function>
+std::array<double, sizeof...(Rules)> fusedNonAdaptiveNonParallel(
+      const Function &f, double a, double b, int subdivisions) {
+	constexpr std::array<int, countFused<Rules...>()> points = fusedPoints<
+	      Rules...>();
+	constexpr std::array<std::array<double, points.size()>, sizeof...(Rules)> weights =
+	      fusedWeights<Rules...>(false);
+	double width = (b - a) / subdivisions;
+
+	std::array<double, sizeof...(Rules)> sums = fusedPanelSums<Policy>(f, a,
+	      width, 0, subdivisions - 1, points, fusedGrid<Rules...>(), weights);
+	return fusedEnds<Policy, Rules...>(f, a, b, width, sums);
+}
+/**
+ * Calculates using parallel sections the integral using several composite rules
+ * at once (see fusedNonAdaptiveNonParallel())
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @return each rule's numerically integrated value, in the order of Rules
+ */
+template<typename Policy, typename... Rules, typename Function>
+std::array<double, sizeof...(Rules)> fusedNonAdaptiveParallel(
+      const Function &f, double a, double b, int subdivisions,
+      int num_threads) {
+	constexpr std::array<int, countFused<Rules...>()> points = fusedPoints<
+	      Rules...>();
+	constexpr std::array<std::array<double, points.size()>, sizeof...(Rules)> weights =
+	      fusedWeights<Rules...>(false);
+	std::vector<std::array<double, sizeof...(Rules)>> partials(num_threads);
+	double width = (b - a) / subdivisions;
+	long panels = subdivisions - 1;
+
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		partials[i] = fusedPanelSums<Policy>(f, a, width, panels * i / num_threads,
+		      panels * (i + 1) / num_threads, points, fusedGrid<Rules...>(),
+		      weights);
+	});
+	std::array<double, sizeof...(Rules)> sums { };
+	for (const std::array<double, sizeof...(Rules)> &partial : partials) {
+		for (size_t r = 0; r < sums.size(); r++) {
+			sums[r] += partial[r];
+		}
+	}
+	return fusedEnds<Policy, Rules...>(f, a, b, width, sums);
+}
+
+/**
+ * Calculates the numerical integral using the adaptive rule.
+ * The adaptive rule divides each section in two until the error goal is met.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double adaptiveNonParallel(const Function &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions) {
+	(*subdivisions) = 1;
+	std::clock_t start = std::clock();
+	std::queue<leftRightInterval<Rule>> intervals;
+	intervals.push(
+	      getLeftRight<Rule, Policy>(wholeInterval<Rule, Policy>(f, a, b), f));
+	double result = 0;
+	double min_width = (b - a) * DBL_EPSILON; // narrower intervals are not divided
+	bool subdivisions_exceeded = false;
+	bool time_exceeded = false;
+	while (!intervals.empty()) {
+		if (((std::clock() - start) / (double) CLOCKS_PER_SEC) > max_time)
+			time_exceeded = true;
+		leftRightInterval<Rule> currentInterval = intervals.front();
+		if ((int) intervals.size() > max_subdivisions)
+			subdivisions_exceeded = true;
+		intervals.pop();
+		double width = currentInterval.right.b - currentInterval.left.a;
+		leftRightInterval<Rule> left = getLeftRight<Rule, Policy>(
+		      currentInterval.left, f);
+		leftRightInterval<Rule> right = getLeftRight<Rule, Policy>(
+		      currentInterval.right, f);
+
+		if (fabs(left.integrated + right.integrated - currentInterval.integrated)
+		      < (Rule::richardson * width * error) || width < min_width
+		      || subdivisions_exceeded || time_exceeded) {
+			result += left.integrated + right.integrated;
+		} else {
+			intervals.push(left);
+			intervals.push(right);
+			(*subdivisions)++;
+		}
+	}
+	return result;
+}
+/**
+ * Calculates using parallel threads the numerical integral using the adaptive rule.
+ * The adaptive rule divides each section in two until the error goal is met.
+ * The threads start from the intervals of balancedPartition()'s pilot which miss
+ * the error goal (see pilotStarts()), each taking a run of neighbours, and idle
+ * threads steal intervals from the others (see Frontier::parallel()).
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double adaptiveParallel(const Function &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      int *subdivisions, double *utilization) {
+	partialSum finished;
+	int count;
+	std::vector<leftRightInterval<Rule>> starts;
+	for (const pilotInterval &pilot : pilotStarts(f, a, b, num_threads, error,
+	      &finished, &count)) {
+		starts.push_back(getLeftRight<Rule, Policy>(
+		      wholeInterval<Rule, Policy>(f, pilot.a, pilot.b), f));
+	}
+	double min_width = (b - a) * DBL_EPSILON; // narrower intervals are not divided
+	auto step = [&](const leftRightInterval<Rule> &current, bool stop,
+	      partialSum *sum, leftRightInterval<Rule> *halves) {
+		double width = current.right.b - current.left.a;
+		halves[0] = getLeftRight<Rule, Policy>(current.left, f);
+		halves[1] = getLeftRight<Rule, Policy>(current.right, f);
+		sum->evaluations += 2 * countNew<Rule>();
+		double integrated = halves[0].integrated + halves[1].integrated;
+		if (fabs(integrated - current.integrated)
+		      < (Rule::richardson * width * error) || width < min_width || stop) {
+			sum->value += integrated;
+			return 0;
+		}
+		return 2;
+	};
+	double result = Frontier::parallel<leftRightInterval<Rule>, 2>(starts, step,
+	      num_threads, max_subdivisions, max_time, subdivisions,
+	      utilization).value;
+	(*subdivisions) += count;
+	return finished.value + result;
+}
+
+/**
+ * Creates the whole interval for the nested schemes, finding the values at every
+ * node. It is integrated when it is divided (see splitNested()).
+ * @param f the function to integrate
+ * @param a the left (starting) point
+ * @param b the right (ending) point
+ * @return the interval
+ */
+template<typename Rule, typename Function>
+nestedInterval<Rule> wholeNested(const Function &f, double a, double b) {
+	nestedInterval<Rule> whole { a, b, 0, { } };
+	std::array<double, Rule::nodes.size()> x;
+	for (size_t k = 0; k < x.size(); k++) {
+		x[k] = a + (b - a) * Rule::nodes[k] / Rule::GRID;
+	}
+	evaluate(f, x.data(), whole.f.data(), x.size());
+	return whole;
+}
+/**
+ * Divides an integrated interval into two and integrates the halves (for the nested
+ * schemes). Every node of the interval is a point of the halves' grid, so only
+ * the halves' nodes which are not also the interval's nodes are evaluated.
+ * The intervals keep the values as found. With the deferredRepair policy, a value
+ * which is not finite is repaired here, once, relative to the width of the
+ * interval being divided (so the interval and its halves agree on it), and again
+ * at a half's own width if that half is divided.
+ * @param current the interval to divide
+ * @param f the function to integrate
+ * @param [out] left the left half
+ * @param [out] right the right half
+ * @return the integral of the interval
+ */
+template<typename Rule, typename Policy, typename Function>
+double splitNested(const nestedInterval<Rule> &current, const Function &f,
+      nestedInterval<Rule> *left, nestedInterval<Rule> *right) {
+	constexpr std::array<int, countNested<Rule>()> points = nestedPoints<Rule>();
+	double width = current.b - current.a;
+	double values[2 * Rule::GRID + 1]; // the function at each step of the halves' grid
+	for (size_t k = 0; k < Rule::nodes.size(); k++) {
+		values[2 * Rule::nodes[k]] = current.f[k];
+	}
+	double x[points.size()];
+	double fx[points.size()];
+	for (size_t i = 0; i < points.size(); i++) {
+		x[i] = current.a + width * points[i] / (2 * Rule::GRID);
+	}
+	evaluate(f, x, fx, points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		values[points[i]] = fx[i];
+	}
+
+	double m = (current.a + current.b) / 2;
+	(*left) = {current.a, m, 0, { }};
+	(*right) = {m, current.b, 0, { }};
+	for (size_t k = 0; k < Rule::nodes.size(); k++) {
+		left->f[k] = values[Rule::nodes[k]];
+		right->f[k] = values[Rule::GRID + Rule::nodes[k]];
+	}
+	if (Policy::repair) {
+		for (size_t i = 0; i < points.size(); i++) {
+			if (!(fabs(values[points[i]]) <= DBL_MAX)) // true for inf and NaN
+				values[points[i]] = repairVal(f, x[i], width);
+		}
+		for (size_t k = 0; k < Rule::nodes.size(); k++) {
+			if (!(fabs(values[2 * Rule::nodes[k]]) <= DBL_MAX))
+				values[2 * Rule::nodes[k]] = repairVal(f,
+				      current.a + width * Rule::nodes[k] / Rule::GRID, width);
+		}
+	}
+
+	double integrated = 0;
+	double left_integrated = 0;
+	double right_integrated = 0;
+	for (size_t k = 0; k < Rule::nodes.size(); k++) {
+		integrated += Rule::weights[k] * values[2 * Rule::nodes[k]];
+		left_integrated += Rule::weights[k] * values[Rule::nodes[k]];
+		right_integrated += Rule::weights[k] * values[Rule::GRID + Rule::nodes[k]];
+	}
+	left->integrated = left_integrated * width / (2 * Rule::divisor);
+	right->integrated = right_integrated * width / (2 * Rule::divisor);
+	return integrated * width / Rule::divisor;
+}
+
+/**
+ * Calculates the numerical integral using the adaptive rule with nested intervals.
+ * The adaptive rule divides each section in two until the error goal is met, as
+ * adaptiveNonParallel() does, but each interval keeps the value at every node, so
+ * dividing it only evaluates the halves' new nodes (countNested() points, rather
+ * than 2 * countNew()), and no value is found twice.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double adaptiveNestedNonParallel(const Function &f, double a, double b,
+      double error, int max_subdivisions, int max_time, int *subdivisions) {
+	(*subdivisions) = 1;
+	std::clock_t start = std::clock();
+	std::queue<nestedInterval<Rule>> intervals;
+	intervals.push(wholeNested<Rule>(f, a, b));
+	double result = 0;
+	double min_width = (b - a) * DBL_EPSILON; // narrower intervals are not divided
+	bool subdivisions_exceeded = false;
+	bool time_exceeded = false;
+	while (!intervals.empty()) {
+		if (((std::clock() - start) / (double) CLOCKS_PER_SEC) > max_time)
+			time_exceeded = true;
+		nestedInterval<Rule> currentInterval = intervals.front();
+		if ((int) intervals.size() > max_subdivisions)
+			subdivisions_exceeded = true;
+		intervals.pop();
+		double width = currentInterval.b - currentInterval.a;
+		nestedInterval<Rule> left;
+		nestedInterval<Rule> right;
+		double integrated = splitNested<Rule, Policy>(currentInterval, f, &left,
+		      &right);
+
+		if (fabs(left.integrated + right.integrated - integrated)
+		      < (Rule::richardson * width * error) || width < min_width
+		      || subdivisions_exceeded || time_exceeded) {
+			result += left.integrated + right.integrated;
+		} else {
+			intervals.push(left);
+			intervals.push(right);
+			(*subdivisions)++;
+		}
+	}
+	return result;
+}
+/**
+ * Calculates using parallel threads the numerical integral using the adaptive rule
+ * with nested intervals.
+ * The threads start from the intervals of balancedPartition()'s pilot which miss
+ * the error goal (see pilotStarts()), each taking a run of neighbours, and idle
+ * threads steal intervals from the others (see Frontier::parallel()).
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double adaptiveNestedParallel(const Function &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      int *subdivisions, double *utilization) {
+	partialSum finished;
+	int count;
+	std::vector<nestedInterval<Rule>> starts;
+	for (const pilotInterval &pilot : pilotStarts(f, a, b, num_threads, error,
+	      &finished, &count)) {
+		starts.push_back(wholeNested<Rule>(f, pilot.a, pilot.b));
+	}
+	double min_width = (b - a) * DBL_EPSILON; // narrower intervals are not divided
+	auto step = [&](const nestedInterval<Rule> &current, bool stop,
+	      partialSum *sum, nestedInterval<Rule> *halves) {
+		double width = current.b - current.a;
+		double whole = splitNested<Rule, Policy>(current, f, &halves[0], &halves[1]);
+		sum->evaluations += countNested<Rule>();
+		double integrated = halves[0].integrated + halves[1].integrated;
+		if (fabs(integrated - whole)
+		      < (Rule::richardson * width * error) || width < min_width || stop) {
+			sum->value += integrated;
+			return 0;
+		}
+		return 2;
+	};
+	double result = Frontier::parallel<nestedInterval<Rule>, 2>(starts, step,
+	      num_threads, max_subdivisions, max_time, subdivisions,
+	      utilization).value;
+	(*subdivisions) += count;
+	return finished.value + result;
+}
+
+/**
+ * Calculates the numerical integral using the globally adaptive rule.
+ * The interval with the largest error estimate is always divided next, until
+ * the summed error estimate meets the error goal.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double adaptiveGlobalNonParallel(const Function &f, double a, double b,
+      double error, int max_subdivisions, int max_time, bool extrapolate,
+      int *subdivisions, double *abserror) {
+	return GlobalAdaptive::nonParallel(
+	      getLeftRight<Rule, Policy>(wholeInterval<Rule, Policy>(f, a, b), f),
+	      getLeftRight<Rule, Policy, Function>, f, Rule::richardson, error,
+	      max_subdivisions, max_time, extrapolate, subdivisions, abserror);
+}
+/**
+ * Calculates using parallel threads the numerical integral using the globally
+ * adaptive rule.
+ * The intervals with the largest error estimates are divided next, until the
+ * summed error estimate meets the error goal.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double adaptiveGlobalParallel(const Function &f, double a, double b,
+      int num_threads, double error, int max_subdivisions, int max_time,
+      bool extrapolate, int *subdivisions, double *abserror) {
+	return GlobalAdaptive::parallel(
+	      getLeftRight<Rule, Policy>(wholeInterval<Rule, Policy>(f, a, b), f),
+	      getLeftRight<Rule, Policy, Function>, f, Rule::richardson, num_threads,
+	      error, max_subdivisions, max_time, extrapolate, subdivisions,
+	      abserror);
+}
+
+/**
+ * The fewest levels (halvings of the trapezoid rule) whose error estimate romberg()
+ * trusts, so a function which happens to agree at the first few grids is not
+ * taken as converged
+ */
+const int ROMBERG_MIN_LEVELS = 4;
+
+/**
+ * Sums the values of a function at the midpoints of a level's subdivisions,
+ * dividing them among the threads when there are enough to be worth it
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision (of the previous level)
+ * @param subdivisions the number of subdivisions (of the previous level)
+ * @param num_threads the number of parallel threads to run
+ * @return the sum of the values
+ */
+template<typename Policy, typename Function>
+double midpointSum(const Function &f, double a, double width, long subdivisions,
+      int num_threads) {
+	static constexpr std::array<double, 1> nodes = { { 0.5 } };
+	static constexpr std::array<double, 1> weights = { { 1 } };
+	if (num_threads <= 1 || subdivisions < (long) num_threads * BATCH_SIZE)
+		return panelSum<Policy>(f, a, width, 0, subdivisions, nodes, weights);
+	std::vector<partialSum> partials(num_threads);
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		long first = subdivisions * i / num_threads;
+		long last = subdivisions * (i + 1) / num_threads;
+		partials[i].value = panelSum<Policy>(f, a, width, first, last, nodes,
+		      weights);
+		partials[i].evaluations = last - first;
+	});
+	return sumPartials(partials).value;
+}
+
+/**
+ * Calculates the numerical integral using Romberg integration.
+ * The trapezoid rule's subdivisions are halved level by level, and since every
+ * point of a level is a point of the next, each level only evaluates the new
+ * midpoints (on num_threads threads), so no value is found twice. Richardson
+ * extrapolation across the levels then removes the error terms h^2, h^4, ...
+ * one column at a time, and the difference of the last two diagonal entries
+ * estimates the error.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the (absolute) error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @param [out] subdivisions the number of subdivisions used (the rule used
+ * subdivisions + 1 evaluations)
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Policy, typename Function>
+double romberg(const Function &f, double a, double b, double error,
+      int max_subdivisions, int num_threads, int *subdivisions,
+      double *abserror) {
+	double width = b - a;
+	double x[2] = { a, b };
+	double fx[2];
+	evaluate(f, x, fx, 2);
+	// a singular end is repaired again at each level, as it would be by the rule
+	auto endSum = [&]() {
+		double sum = 0;
+		for (int i = 0; i < 2; i++) {
+			sum += (Policy::repair && !(fabs(fx[i]) <= DBL_MAX)) ?
+			      repairVal(f, x[i], width) : fx[i];
+		}
+		return sum;
+	};
+	double interior = 0; // the sum of every value but the ends
+	Extrapolation::richardsonTableau table(2, 2);
+	double result;
+	table.add(0.5 * width * endSum(), &result, abserror);
+	(*subdivisions) = 1;
+	(*abserror) = fabs(result);
+	int levels = 1;
+	while (2 * (*subdivisions) <= max_subdivisions) {
+		interior += midpointSum<Policy>(f, a, width, *subdivisions, num_threads);
+		(*subdivisions) *= 2;
+		width *= 0.5;
+		levels++;
+		table.add(width * (0.5 * endSum() + interior), &result, abserror);
+		if (levels > ROMBERG_MIN_LEVELS && (*abserror) <= error)
+			break;
+	}
+	return result;
+}
+
+/**
+ * The fewest levels whose error estimate extrapolated() trusts, so a function which
+ * happens to agree at the first few grids is not taken as converged
+ */
+const int EXTRAPOLATION_MIN_LEVELS = 4;
+/**
+ * The coarsest levels left out of Wynn's epsilon table in extrapolated(): they
+ * sample too little of the function to follow the sequence's asymptotic behaviour,
+ * and can agree by chance (as the trapezoid rule does on floor(x) from 0 to 2),
+ * which the table would take as convergence
+ */
+const int EPSILON_SKIPPED_LEVELS = 2;
+/**
+ * The largest change of the raw sums in extrapolated(), relative to their value,
+ * at which Wynn's epsilon table is trusted. Before a rule reaches its asymptotic
+ * range its sums can shrink geometrically (as on x^10000 from 0 to 1, until the
+ * grid resolves the peak), which the table extrapolates to the wrong limit.
+ */
+const double EPSILON_SETTLED = 0.1;
+/**
+ * How many times the raw sums' last change the epsilon table's limit may lie
+ * from the latest sum in extrapolated(), for its estimate to be trusted
+ */
+const double EPSILON_AGREEMENT = 10;
+
+/**
+ * @param c a step of the grid (0 to GRID-1)
+ * @return true if the composite rule has a point at every step of its grid which is
+ * c more than a multiple of GRID
+ */
+template<typename Rule>
+constexpr bool isNodeClass(int c) {
+	for (int node : Rule::nodes) {
+		if (node % Rule::GRID == c)
+			return true;
+	}
+	return false;
+}
+/**
+ * @return the smallest factor (at least 2) the composite rule's subdivisions can be
+ * multiplied by so that every point of the rule is also a point of the refined rule
+ * (2 for every rule but the midpoint rule, which needs 3)
+ */
+template<typename Rule>
+constexpr int nestingRatio() {
+	for (int r = 2;; r++) {
+		bool nested = true;
+		for (int c = 0; c < Rule::GRID; c++) {
+			if (isNodeClass<Rule>(c) && !isNodeClass<Rule>(r * c % Rule::GRID))
+				nested = false;
+		}
+		if (nested)
+			return r;
+	}
+}
+/**
+ * @return the weight of the points of each class of the composite rule's grid (a
+ * shared end has the weight of both subdivisions it ends)
+ */
+template<typename Rule>
+constexpr std::array<double, Rule::GRID> classWeights() {
+	std::array<double, Rule::GRID> weights { };
+	for (size_t k = 0; k < Rule::nodes.size(); k++) {
+		weights[Rule::nodes[k] % Rule::GRID] += Rule::weights[k];
+	}
+	return weights;
+}
+/**
+ * @param p a step of the refined grid within one subdivision before refinement (0
+ * to nestingRatio() * GRID - 1)
+ * @return true if the refined rule has a point at p which the rule did not
+ */
+template<typename Rule>
+constexpr bool isRefinedNew(int p) {
+	return isNodeClass<Rule>(p % Rule::GRID)
+	      && !(p % nestingRatio<Rule>() == 0
+	            && isNodeClass<Rule>(p / nestingRatio<Rule>()));
+}
+/**
+ * @return the number of points refining each subdivision evaluates
+ */
+template<typename Rule>
+constexpr int countRefined() {
+	int count = 0;
+	for (int p = 0; p < nestingRatio<Rule>() * Rule::GRID; p++) {
+		if (isRefinedNew<Rule>(p))
+			count++;
+	}
+	return count;
+}
+/**
+ * @return the steps of the refined grid, within one subdivision before refinement,
+ * which refining evaluates
+ */
+template<typename Rule>
+constexpr std::array<int, countRefined<Rule>()> refinedPoints() {
+	std::array<int, countRefined<Rule>()> points { };
+	int count = 0;
+	for (int p = 0; p < nestingRatio<Rule>() * Rule::GRID; p++) {
+		if (isRefinedNew<Rule>(p))
+			points[count++] = p;
+	}
+	return points;
+}
+/**
+ * @return the number of points of the rule strictly inside its interval
+ */
+template<typename Rule>
+constexpr int countInterior() {
+	int count = 0;
+	for (int node : Rule::nodes) {
+		if (node > 0 && node < Rule::GRID)
+			count++;
+	}
+	return count;
+}
+/**
+ * @return the steps of the rule's points strictly inside its interval
+ */
+template<typename Rule>
+constexpr std::array<int, countInterior<Rule>()> interiorPoints() {
+	std::array<int, countInterior<Rule>()> points { };
+	int count = 0;
+	for (int node : Rule::nodes) {
+		if (node > 0 && node < Rule::GRID)
+			points[count++] = node;
+	}
+	return points;
+}
+
+/**
+ * Adds the values of a function at the same points of subdivisions first to last-1
+ * to the sums of their classes of the grid
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision
+ * @param first the first subdivision
+ * @param last one past the last subdivision
+ * @param points the points, in steps of a grid of scale steps per subdivision
+ * @param scale the number of steps in each subdivision
+ * @param [out] sums the sum of the values of each class (the step modulo GRID)
+ */
+template<typename Rule, typename Policy, typename Function, size_t P>
+void classSums(const Function &f, double a, double width, long first,
+      long last, const std::array<int, P> &points, int scale,
+      std::array<double, Rule::GRID> *sums) {
+	const int panels = BATCH_SIZE / P > 0 ? BATCH_SIZE / P : 1; // per block
+	double x[panels * P];
+	double fx[panels * P];
+	for (long j = first; j < last; j += panels) {
+		int count = (int) std::min<long>(panels, last - j);
+		for (int p = 0; p < count; p++) {
+			for (size_t k = 0; k < P; k++) {
+				x[p * P + k] = a + (j + p + points[k] / (double) scale) * width;
+			}
+		}
+		findVals<Policy>(f, x, fx, count * P, width);
+		for (int p = 0; p < count; p++) {
+			for (size_t k = 0; k < P; k++) {
+				(*sums)[points[k] % Rule::GRID] += fx[p * P + k];
+			}
+		}
+	}
+}
+/**
+ * Adds the values of a function at the same points of every subdivision to the sums
+ * of their classes, dividing the subdivisions among the threads when there are
+ * enough to be worth it
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral
+ * @param width the size of each subdivision
+ * @param subdivisions the number of subdivisions
+ * @param points the points, in steps of a grid of scale steps per subdivision
+ * @param scale the number of steps in each subdivision
+ * @param num_threads the number of parallel threads to run
+ * @param [out] sums the sum of the values of each class (the step modulo GRID)
+ */
+template<typename Rule, typename Policy, typename Function, size_t P>
+void classSumsParallel(const Function &f, double a, double width,
+      long subdivisions, const std::array<int, P> &points, int scale,
+      int num_threads, std::array<double, Rule::GRID> *sums) {
+	if (num_threads <= 1 || subdivisions < (long) num_threads * BATCH_SIZE) {
+		classSums<Rule, Policy>(f, a, width, 0, subdivisions, points, scale, sums);
+		return;
+	}
+	std::vector<std::array<double, Rule::GRID>> partials(num_threads);
+	ThreadPool::getInstance().run(num_threads, [&](int i) {
+		partials[i].fill(0);
+		classSums<Rule, Policy>(f, a, width, subdivisions * i / num_threads,
+		      subdivisions * (i + 1) / num_threads, points, scale, &partials[i]);
+	});
+	for (const std::array<double, Rule::GRID> &partial : partials) {
+		for (int c = 0; c < Rule::GRID; c++) {
+			(*sums)[c] += partial[c];
+		}
+	}
+}
+
+/**
+ * Calculates the numerical integral by extrapolating the composite rule over a
+ * geometric sequence of subdivisions.
+ * The subdivisions are multiplied by nestingRatio() level by level, so every point
+ * of a level is a point of the next, and each level only evaluates the new points
+ * (on num_threads threads). The values are kept summed by their class of the grid,
+ * since a point's weight depends only on its class. Richardson extrapolation then
+ * removes the error terms width^order, width^(order+2), ... one column at a time,
+ * as in romberg(), or (if epsilon) Wynn's epsilon algorithm extrapolates the
+ * sequence, which also accelerates the non-integer powers a singularity introduces.
+ * The table's limit is only used once the sums have settled and it agrees with
+ * them; until then the result is the latest sum, and its error the last change.
+ * Either stops when successive extrapolations agree to within the error goal.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the (absolute) error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @param epsilon whether to use Wynn's epsilon algorithm rather than Richardson
+ * extrapolation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Rule, typename Policy, typename Function>
+double extrapolated(const Function &f, double a, double b, double error,
+      int max_subdivisions, int num_threads, bool epsilon, int *subdivisions,
+      double *abserror) {
+	static constexpr std::array<double, Rule::GRID> weights =
+	      classWeights<Rule>();
+	static constexpr int ratio = nestingRatio<Rule>();
+	double width = b - a;
+	double x[2] = { a, b };
+	double fx[2];
+	if (sharedEnds<Rule>())
+		evaluate(f, x, fx, 2);
+	// a singular end is repaired again at each level, as it would be by the rule
+	auto endSum = [&]() {
+		double sum = 0;
+		for (int i = 0; sharedEnds<Rule>() && i < 2; i++) {
+			sum += (Policy::repair && !(fabs(fx[i]) <= DBL_MAX)) ?
+			      repairVal(f, x[i], width) : fx[i];
+		}
+		return Rule::weights[0] * sum;
+	};
+	auto level = [&](const std::array<double, Rule::GRID> &sums) {
+		double sum = endSum();
+		for (int c = 0; c < Rule::GRID; c++) {
+			sum += weights[c] * sums[c];
+		}
+		return width * sum / Rule::divisor;
+	};
+
+	std::array<double, Rule::GRID> sums { }; // every value but the ends, by class
+	if constexpr (countInterior<Rule>() > 0)
+		classSums<Rule, Policy>(f, a, width, 0, 1, interiorPoints<Rule>(),
+		      Rule::GRID, &sums);
+	(*subdivisions) = 1;
+	Extrapolation::richardsonTableau tableau(Rule::order, ratio);
+	Extrapolation::wynnEpsilon table;
+	double result = level(sums);
+	double last = result; // the last level's value
+	double estimate = 0;
+	if (!epsilon)
+		tableau.add(result, &result, abserror);
+	(*abserror) = fabs(result);
+	int levels = 1;
+	while ((long) ratio * (*subdivisions) <= max_subdivisions) {
+		std::array<double, Rule::GRID> refined { };
+		for (int c = 0; c < Rule::GRID; c++) { // the old points, on the new grid
+			refined[ratio * c % Rule::GRID] += sums[c];
+		}
+		classSumsParallel<Rule, Policy>(f, a, width, *subdivisions,
+		      refinedPoints<Rule>(), ratio * Rule::GRID, num_threads, &refined);
+		sums = refined;
+		(*subdivisions) *= ratio;
+		width /= ratio;
+		levels++;
+
+		double value = level(sums);
+		if (epsilon) {
+			// the raw change is the error until the sums settle and the limit agrees
+			double change = fabs(value - last);
+			double limit;
+			last = value;
+			result = value;
+			(*abserror) = change;
+			if (levels > EPSILON_SKIPPED_LEVELS
+			      && table.add(value, &limit, &estimate)
+			      && change <= EPSILON_SETTLED * fabs(value)
+			      && fabs(limit - value) <= EPSILON_AGREEMENT * change) {
+				result = limit;
+				(*abserror) = estimate;
+			}
+		} else {
+			tableau.add(value, &result, abserror);
+		}
+		// successive results cannot agree more closely than their rounding
+		if (levels > EXTRAPOLATION_MIN_LEVELS && (*abserror)
+		      <= std::max(error, 100 * DBL_EPSILON * fabs(result)))
+			break;
+	}
+	return result;
+}
+}
+
+#endif /* NEWTONCOTES_H_ */
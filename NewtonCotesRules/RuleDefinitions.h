@@ -0,0 +1,232 @@
+/**
+ * @file RuleDefinitions.h
+ * @brief Contains the functions taking a batchFunction shared by every Newton-Cotes rule
+ * Each rule's source file includes this and explicitly instantiates RuleFunctions
+ * for its rule, so the functions are compiled once for each rule.
+ * @author Irene Crowell
+ */
+#ifndef RULEDEFINITIONS_H_
+#define RULEDEFINITIONS_H_
+#include "RuleFunctions.h"
+
+/**
+ * Calculates the numerical integral using the rule
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::nonAdaptiveNonParallel(const batchFunction &f,
+      double a, double b, int subdivisions) {
+	return NewtonCotes::nonAdaptiveNonParallel<Rule, deferredRepair>(f, a, b,
+	      subdivisions);
+}
+/**
+ * Calculates using parallel sections the integral using the rule
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::nonAdaptiveParallel(const batchFunction &f,
+      double a, double b, int subdivisions, int num_threads) {
+	return NewtonCotes::nonAdaptiveParallel<Rule, deferredRepair>(f, a, b,
+	      subdivisions, num_threads);
+}
+/**
+ * Calculates the numerical integral using the rule, and estimates its error
+ * from the same values
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param [out] abserror the estimated error
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::nonAdaptiveNonParallel(const batchFunction &f,
+      double a, double b, int subdivisions, double *abserror) {
+	return NewtonCotes::nonAdaptiveNonParallel<Rule, deferredRepair>(f, a, b,
+	      subdivisions, abserror);
+}
+/**
+ * Calculates using parallel sections the integral using the rule, and estimates
+ * its error from the same values
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param subdivisions the number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @param [out] abserror the estimated error
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::nonAdaptiveParallel(const batchFunction &f,
+      double a, double b, int subdivisions, int num_threads, double *abserror) {
+	return NewtonCotes::nonAdaptiveParallel<Rule, deferredRepair>(f, a, b,
+	      subdivisions, num_threads, abserror);
+}
+/**
+ * Calculates the numerical integral using the adaptive rule.
+ * The adaptive rule divides each section in two until the error goal is met.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::adaptiveNonParallel(const batchFunction &f,
+      double a, double b, double error, int max_subdivisions, int max_time,
+      int *subdivisions) {
+	return NewtonCotes::adaptiveNonParallel<Rule, deferredRepair>(f, a, b, error,
+	      max_subdivisions, max_time, subdivisions);
+}
+/**
+ * Calculates using parallel threads the numerical integral using the adaptive rule.
+ * The adaptive rule divides each section in two until the error goal is met.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::adaptiveParallel(const batchFunction &f, double a,
+      double b, int num_threads, double error, int max_subdivisions,
+      int max_time, int *subdivisions, double *utilization) {
+	return NewtonCotes::adaptiveParallel<Rule, deferredRepair>(f, a, b, num_threads,
+	      error, max_subdivisions, max_time, subdivisions, utilization);
+}
+/**
+ * Calculates the numerical integral using the globally adaptive rule.
+ * The interval with the largest error estimate is always divided next, until
+ * the summed error estimate meets the error goal.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::adaptiveGlobalNonParallel(const batchFunction &f,
+      double a, double b, double error, int max_subdivisions, int max_time,
+      bool extrapolate, int *subdivisions, double *abserror) {
+	return NewtonCotes::adaptiveGlobalNonParallel<Rule, deferredRepair>(f, a, b,
+	      error, max_subdivisions, max_time, extrapolate, subdivisions, abserror);
+}
+/**
+ * Calculates using parallel threads the numerical integral using the globally
+ * adaptive rule.
+ * The intervals with the largest error estimates are divided next, until the
+ * summed error estimate meets the error goal.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the (absolute) error goal for the whole integral
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param extrapolate whether to apply Richardson extrapolation to each interval
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::adaptiveGlobalParallel(const batchFunction &f,
+      double a, double b, int num_threads, double error, int max_subdivisions,
+      int max_time, bool extrapolate, int *subdivisions, double *abserror) {
+	return NewtonCotes::adaptiveGlobalParallel<Rule, deferredRepair>(f, a, b,
+	      num_threads, error, max_subdivisions, max_time, extrapolate,
+	      subdivisions, abserror);
+}
+/**
+ * Calculates the numerical integral by extrapolating the rule over a
+ * geometric sequence of subdivisions.
+ * Each level only evaluates the points the previous levels did not, in parallel,
+ * and the extrapolation continues until successive results meet the error goal.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the (absolute) error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param num_threads the number of parallel threads to run
+ * @param epsilon whether to use Wynn's epsilon algorithm rather than Richardson
+ * extrapolation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] abserror the estimated error achieved
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::extrapolated(const batchFunction &f, double a,
+      double b, double error, int max_subdivisions, int num_threads,
+      bool epsilon, int *subdivisions, double *abserror) {
+	return NewtonCotes::extrapolated<Rule, deferredRepair>(f, a, b, error,
+	      max_subdivisions, num_threads, epsilon, subdivisions, abserror);
+}
+/**
+ * Calculates the numerical integral using the adaptive rule with nested intervals.
+ * Each interval keeps the value at every node, so dividing it only evaluates the
+ * halves' new nodes.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::adaptiveNestedNonParallel(const batchFunction &f,
+      double a, double b, double error, int max_subdivisions, int max_time,
+      int *subdivisions) {
+	return NewtonCotes::adaptiveNestedNonParallel<Rule, deferredRepair>(f, a, b,
+	      error, max_subdivisions, max_time, subdivisions);
+}
+/**
+ * Calculates using parallel threads the numerical integral using the adaptive
+ * rule with nested intervals.
+ * Each interval keeps the value at every node, so dividing it only evaluates the
+ * halves' new nodes.
+ * @param f	the function to integrate
+ * @param a the left (starting) point of the integral section
+ * @param b the right (ending) point of the integral section
+ * @param num_threads the number of parallel threads to run
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param max_time the time limit for the calculation
+ * @param [out] subdivisions the number of subdivisions used
+ * @param [out] utilization the fraction of the threads' time spent integrating
+ * (may be NULL)
+ * @return the numerically integrated value
+ */
+template<typename Rule>
+double RuleFunctions<Rule>::adaptiveNestedParallel(const batchFunction &f,
+      double a, double b, int num_threads, double error, int max_subdivisions,
+      int max_time, int *subdivisions, double *utilization) {
+	return NewtonCotes::adaptiveNestedParallel<Rule, deferredRepair>(f, a, b,
+	      num_threads, error, max_subdivisions, max_time, subdivisions,
+	      utilization);
+}
+
+#endif /* RULEDEFINITIONS_H_ */
@@ -0,0 +1,140 @@
+/**
+ * @file RuleFunctions.h
+ * @brief Contains the functions shared by every Newton-Cotes rule
+ * Each rule in RuleHeaders.h is a struct deriving from RuleFunctions, given the
+ * rule's description, so every rule has the same functions and each is written
+ * once. The functions taking a batchFunction are defined in RuleDefinitions.h
+ * and instantiated once for each rule, in the rule's source file.
+ * @author Irene Crowell
+ */
+#ifndef RULEFUNCTIONS_H_
+#define RULEFUNCTIONS_H_
+#include "NewtonCotes.h"
+
+/**
+ * The functions of a Newton-Cotes rule, for the schemes in NewtonCotes.h
+ * @tparam Rule the rule's description (its points, weights and error terms)
+ */
+template<typename Rule>
+struct RuleFunctions {
+	typedef Rule rule; //!<the rule's description
+
+	static double nonAdaptiveNonParallel(const batchFunction &f, double a,
+	      double b, int subdivisions);
+	static double nonAdaptiveParallel(const batchFunction &f, double a,
+	      double b, int subdivisions, int num_threads);
+	static double nonAdaptiveNonParallel(const batchFunction &f, double a,
+	      double b, int subdivisions, double *abserror);
+	static double nonAdaptiveParallel(const batchFunction &f, double a,
+	      double b, int subdivisions, int num_threads, double *abserror);
+	static double adaptiveNonParallel(const batchFunction &f, double a,
+	      double b, double error, int max_subdivisions, int max_time,
+	      int *subdivisions);
+	static double adaptiveParallel(const batchFunction &f, double a, double b,
+	      int num_threads, double error, int max_subdivisions, int max_time,
+	      int *subdivisions, double *utilization = NULL);
+	static double adaptiveGlobalNonParallel(const batchFunction &f, double a,
+	      double b, double error, int max_subdivisions, int max_time,
+	      bool extrapolate, int *subdivisions, double *abserror);
+	static double adaptiveGlobalParallel(const batchFunction &f, double a,
+	      double b, int num_threads, double error, int max_subdivisions,
+	      int max_time, bool extrapolate, int *subdivisions, double *abserror);
+	static double extrapolated(const batchFunction &f, double a, double b,
+	      double error, int max_subdivisions, int num_threads, bool epsilon,
+	      int *subdivisions, double *abserror);
+	static double adaptiveNestedNonParallel(const batchFunction &f, double a,
+	      double b, double error, int max_subdivisions, int max_time,
+	      int *subdivisions);
+	static double adaptiveNestedParallel(const batchFunction &f, double a,
+	      double b, int num_threads, double error, int max_subdivisions,
+	      int max_time, int *subdivisions, double *utilization = NULL);
+
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double nonAdaptiveNonParallel(const Function &f, double a, double b,
+	      int subdivisions) {
+		return NewtonCotes::nonAdaptiveNonParallel<Rule, Policy>(f, a, b,
+		      subdivisions);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double nonAdaptiveParallel(const Function &f, double a, double b,
+	      int subdivisions, int num_threads) {
+		return NewtonCotes::nonAdaptiveParallel<Rule, Policy>(f, a, b,
+		      subdivisions, num_threads);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double nonAdaptiveNonParallel(const Function &f, double a, double b,
+	      int subdivisions, double *abserror) {
+		return NewtonCotes::nonAdaptiveNonParallel<Rule, Policy>(f, a, b,
+		      subdivisions, abserror);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double nonAdaptiveParallel(const Function &f, double a, double b,
+	      int subdivisions, int num_threads, double *abserror) {
+		return NewtonCotes::nonAdaptiveParallel<Rule, Policy>(f, a, b,
+		      subdivisions, num_threads, abserror);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double adaptiveNonParallel(const Function &f, double a, double b,
+	      double error, int max_subdivisions, int max_time, int *subdivisions) {
+		return NewtonCotes::adaptiveNonParallel<Rule, Policy>(f, a, b, error,
+		      max_subdivisions, max_time, subdivisions);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double adaptiveParallel(const Function &f, double a, double b,
+	      int num_threads, double error, int max_subdivisions, int max_time,
+	      int *subdivisions, double *utilization = NULL) {
+		return NewtonCotes::adaptiveParallel<Rule, Policy>(f, a, b, num_threads,
+		      error, max_subdivisions, max_time, subdivisions, utilization);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double adaptiveGlobalNonParallel(const Function &f, double a,
+	      double b, double error, int max_subdivisions, int max_time,
+	      bool extrapolate, int *subdivisions, double *abserror) {
+		return NewtonCotes::adaptiveGlobalNonParallel<Rule, Policy>(f, a, b,
+		      error, max_subdivisions, max_time, extrapolate, subdivisions,
+		      abserror);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double adaptiveGlobalParallel(const Function &f, double a, double b,
+	      int num_threads, double error, int max_subdivisions, int max_time,
+	      bool extrapolate, int *subdivisions, double *abserror) {
+		return NewtonCotes::adaptiveGlobalParallel<Rule, Policy>(f, a, b,
+		      num_threads, error, max_subdivisions, max_time, extrapolate,
+		      subdivisions, abserror);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double extrapolated(const Function &f, double a, double b,
+	      double error, int max_subdivisions, int num_threads, bool epsilon,
+	      int *subdivisions, double *abserror) {
+		return NewtonCotes::extrapolated<Rule, Policy>(f, a, b, error,
+		      max_subdivisions, num_threads, epsilon, subdivisions, abserror);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double adaptiveNestedNonParallel(const Function &f, double a,
+	      double b, double error, int max_subdivisions, int max_time,
+	      int *subdivisions) {
+		return NewtonCotes::adaptiveNestedNonParallel<Rule, Policy>(f, a, b,
+		      error, max_subdivisions, max_time, subdivisions);
+	}
+	template<typename Policy = deferredRepair, typename Function,
+	      ifEvaluable<Function> = 0>
+	static double adaptiveNestedParallel(const Function &f, double a, double b,
+	      int num_threads, double error, int max_subdivisions, int max_time,
+	      int *subdivisions, double *utilization = NULL) {
+		return NewtonCotes::adaptiveNestedParallel<Rule, Policy>(f, a, b,
+		      num_threads, error, max_subdivisions, max_time, subdivisions,
+		      utilization);
+	}
+};
+
+#endif /* RULEFUNCTIONS_H_ */
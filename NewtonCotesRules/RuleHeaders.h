@@ -1,62 +1,156 @@
 /**
  * @file RuleHeaders.h
  * @brief Contains function prototypes for the Newton Cotes Rules
+ * Each rule has a description for the schemes in NewtonCotes.h (in
+ * RuleDescriptions), and every rule has the same functions (see RuleFunctions.h).
+ * The functions taking a batchFunction (or a gsl_function, which converts to one)
+ * are compiled once, in the rule's source file (see RuleDefinitions.h). The
+ * templates take any callable f, with f(x) the value of the function at x, and are
+ * compiled where they are called, so the callable is inlined.
+ * They also take an evaluation policy, for example
+ * BoolesRule::nonAdaptiveNonParallel<unchecked>(f, a, b, subdivisions) for a function
+ * without singularities, where f may also be a batchFunction.
  * @author Irene Crowell
  */
 #ifndef RULEHEADERS_H_
 #define RULEHEADERS_H_
+#include "NewtonCotes.h"
+#include "RuleFunctions.h"
 
-namespace MidpointRule {
-double nonAdaptiveNonParallel(gsl_function f, double a, double b,
-      int subdivisions);
-double nonAdaptiveParallel(gsl_function f, double a, double b, int subdivisions,
-      int num_threads);
-double adaptiveNonParallel(gsl_function f, double a, double b, double error,
-      int max_subdivisions, int max_time, int *subdivisions);
-double adaptiveParallel(gsl_function f, double a, double b, int num_threads,
-      double error, int max_subdivisions, int max_time, int *subdivisions);
+namespace RuleDescriptions {
+/**
+ * The midpoint rule: one point, in the middle of each interval
+ */
+struct midpoint {
+	static constexpr int GRID = 2; //!<the number of steps the points are placed on
+	static constexpr std::array<int, 1> nodes = { { 1 } }; //!<the points, in steps from a
+	static constexpr std::array<double, 1> weights = { { 1 } }; //!<the weight of each point
+	static constexpr double divisor = 1; //!<the integral is width * (weighted sum) / divisor
+	static constexpr std::array<int, 0> stored = { { } }; //!<the points kept for the halves (none are shared)
+	static constexpr double richardson = 3; //!<Richardson Extrapolation for error ((4^1)-1)
+	static constexpr int order = 2; //!<the error of the composite rule falls as width^order
+};
 
+/**
+ * The trapezoid rule: the two ends of each interval
+ */
+struct trapezoid {
+	static constexpr int GRID = 2; //!<the number of steps the points are placed on
+	static constexpr std::array<int, 2> nodes = { { 0, 2 } }; //!<the points, in steps from a
+	static constexpr std::array<double, 2> weights = { { 1, 1 } }; //!<the weight of each point
+	static constexpr double divisor = 2; //!<the integral is width * (weighted sum) / divisor
+	static constexpr std::array<int, 2> stored = { { 0, 2 } }; //!<the points kept for the halves
+	static constexpr double richardson = 3; //!<Richardson Extrapolation for error ((4^1)-1)
+	static constexpr int order = 2; //!<the error of the composite rule falls as width^order
+};
+
+/**
+ * Simpson's rule: the ends and midpoint of each interval
+ */
+struct simpson {
+	static constexpr int GRID = 4; //!<the number of steps the points are placed on
+	static constexpr std::array<int, 3> nodes = { { 0, 2, 4 } }; //!<the points, in steps from a
+	static constexpr std::array<double, 3> weights = { { 1, 4, 1 } }; //!<the weight of each point
+	static constexpr double divisor = 6; //!<the integral is width * (weighted sum) / divisor
+	static constexpr std::array<int, 3> stored = { { 0, 2, 4 } }; //!<the points kept for the halves
+	static constexpr double richardson = 15; //!<Richardson Extrapolation for error ((4^2)-1)
+	static constexpr int order = 4; //!<the error of the composite rule falls as width^order
+};
+
+/**
+ * Simpson's 3/8 rule: the ends and thirds of each interval (the thirds are not
+ * points of the halves, so only the ends are kept)
+ */
+struct simpson38 {
+	static constexpr int GRID = 6; //!<the number of steps the points are placed on
+	static constexpr std::array<int, 4> nodes = { { 0, 2, 4, 6 } }; //!<the points, in steps from a
+	static constexpr std::array<double, 4> weights = { { 1, 3, 3, 1 } }; //!<the weight of each point
+	static constexpr double divisor = 8; //!<the integral is width * (weighted sum) / divisor
+	static constexpr std::array<int, 2> stored = { { 0, 6 } }; //!<the points kept for the halves
+	static constexpr double richardson = 63; //!<Richardson Extrapolation for error ((4^3)-1)
+	static constexpr int order = 4; //!<the error of the composite rule falls as width^order
+};
+
+/**
+ * Boole's rule: the ends and quarters of each interval
+ */
+struct boole {
+	static constexpr int GRID = 4; //!<the number of steps the points are placed on
+	static constexpr std::array<int, 5> nodes = { { 0, 1, 2, 3, 4 } }; //!<the points, in steps from a
+	static constexpr std::array<double, 5> weights = { { 7, 32, 12, 32, 7 } }; //!<the weight of each point
+	static constexpr double divisor = 90; //!<the integral is width * (weighted sum) / divisor
+	static constexpr std::array<int, 3> stored = { { 0, 2, 4 } }; //!<the points kept for the halves
+	static constexpr double richardson = 255; //!<Richardson Extrapolation for error ((4^4)-1)
+	static constexpr int order = 6; //!<the error of the composite rule falls as width^order
+};
 }
-namespace TrapezoidRule {
-double nonAdaptiveNonParallel(gsl_function f, double a, double b,
-      int subdivisions);
-double nonAdaptiveParallel(gsl_function f, double a, double b, int subdivisions,
-      int num_threads);
-double adaptiveNonParallel(gsl_function f, double a, double b, double error,
-      int max_subdivisions, int max_time, int *subdivisions);
-double adaptiveParallel(gsl_function f, double a, double b, int num_threads,
-      double error, int max_subdivisions, int max_time, int *subdivisions);
-}
 
-namespace SimpsonRule {
-double nonAdaptiveNonParallel(gsl_function f, double a, double b,
-      int subdivisions);
-double nonAdaptiveParallel(gsl_function f, double a, double b, int subdivisions,
-      int num_threads);
-double adaptiveNonParallel(gsl_function f, double a, double b, double error,
-      int max_subdivisions, int max_time, int *subdivisions);
-double adaptiveParallel(gsl_function f, double a, double b, int num_threads,
-      double error, int max_subdivisions, int max_time, int *subdivisions);
+extern template struct RuleFunctions<RuleDescriptions::midpoint>;
+/**
+ * The functions of the midpoint rule
+ */
+struct MidpointRule : RuleFunctions<RuleDescriptions::midpoint> {
+};
+
+extern template struct RuleFunctions<RuleDescriptions::trapezoid>;
+/**
+ * The functions of the trapezoid rule
+ */
+struct TrapezoidRule : RuleFunctions<RuleDescriptions::trapezoid> {
+	static double romberg(const batchFunction &f, double a, double b,
+	      double error, int max_subdivisions, int num_threads, int *subdivisions,
+	      double *abserror);
+};
+
+extern template struct RuleFunctions<RuleDescriptions::simpson>;
+/**
+ * The functions of Simpson's rule
+ */
+struct SimpsonRule : RuleFunctions<RuleDescriptions::simpson> {
+};
+
+extern template struct RuleFunctions<RuleDescriptions::simpson38>;
+/**
+ * The functions of Simpson's 3/8 rule
+ */
+struct Simpson38Rule : RuleFunctions<RuleDescriptions::simpson38> {
+};
+
+extern template struct RuleFunctions<RuleDescriptions::boole>;
+/**
+ * The functions of Boole's rule
+ */
+struct BoolesRule : RuleFunctions<RuleDescriptions::boole> {
+};
+
+namespace AllRules {
+/**
+ * The number of rules, whose results are in the order midpoint, trapezoid,
+ * Simpson's, Simpson's 3/8 and Boole's
+ */
+const int RULES = 5;
+
+std::array<double, RULES> nonAdaptiveNonParallel(const batchFunction &f,
+      double a, double b, int subdivisions);
+std::array<double, RULES> nonAdaptiveParallel(const batchFunction &f, double a,
+      double b, int subdivisions, int num_threads);
+
+template<typename Policy = deferredRepair, typename Function,
+      ifEvaluable<Function> = 0>
+std::array<double, RULES> nonAdaptiveNonParallel(const Function &f, double a,
+      double b, int subdivisions) {
+	return NewtonCotes::fusedNonAdaptiveNonParallel<Policy, MidpointRule::rule,
+	      TrapezoidRule::rule, SimpsonRule::rule, Simpson38Rule::rule,
+	      BoolesRule::rule>(f, a, b, subdivisions);
 }
-namespace Simpson38Rule {
-double nonAdaptiveNonParallel(gsl_function f, double a, double b,
-      int subdivisions);
-double nonAdaptiveParallel(gsl_function f, double a, double b, int subdivisions,
-      int num_threads);
-double adaptiveNonParallel(gsl_function f, double a, double b, double error,
-      int max_subdivisions, int max_time, int *subdivisions);
-double adaptiveParallel(gsl_function f, double a, double b, int num_threads,
-      double error, int max_subdivisions, int max_time, int *subdivisions);
+template<typename Policy = deferredRepair, typename Function,
+      ifEvaluable<Function> = 0>
+std::array<double, RULES> nonAdaptiveParallel(const Function &f, double a,
+      double b, int subdivisions, int num_threads) {
+	return NewtonCotes::fusedNonAdaptiveParallel<Policy, MidpointRule::rule,
+	      TrapezoidRule::rule, SimpsonRule::rule, Simpson38Rule::rule,
+	      BoolesRule::rule>(f, a, b, subdivisions, num_threads);
 }
-namespace BoolesRule {
-double nonAdaptiveNonParallel(gsl_function f, double a, double b,
-      int subdivisions);
-double nonAdaptiveParallel(gsl_function f, double a, double b, int subdivisions,
-      int num_threads);
-double adaptiveNonParallel(gsl_function f, double a, double b, double error,
-      int max_subdivisions, int max_time, int *subdivisions);
-double adaptiveParallel(gsl_function f, double a, double b, int num_threads,
-      double error, int max_subdivisions, int max_time, int *subdivisions);
 }
 
 #endif /* RULEHEADERS_H_ */
@@ -0,0 +1,37 @@
+/**
+ * @file PartialSum.h
+ * @brief Contains the per-thread partial sums combined when parallel threads finish
+ * @author Irene Crowell
+ */
+#ifndef PARTIALSUM_H_
+#define PARTIALSUM_H_
+#include <vector>
+
+/**
+ * One thread's share of an integral. Each thread writes only its own partialSum,
+ * and they are added together once every thread has finished, so threads never
+ * wait on a lock for the result. Aligned to a cache line so neighbouring threads'
+ * sums do not share one.
+ */
+struct alignas(64) partialSum {
+	double value = 0; //!<the sum of the thread's integrated sections
+	double error = 0; //!<the sum of the thread's (squared) error estimates
+	long evaluations = 0; //!<the number of function evaluations made
+};
+
+/**
+ * Adds together the partial sums of every thread
+ * @param partials the partial sums
+ * @return the total
+ */
+inline partialSum sumPartials(const std::vector<partialSum> &partials) {
+	partialSum total;
+	for (const partialSum &partial : partials) {
+		total.value += partial.value;
+		total.error += partial.error;
+		total.evaluations += partial.evaluations;
+	}
+	return total;
+}
+
+#endif /* PARTIALSUM_H_ */
@@ -0,0 +1,207 @@
+/**
+ * @file Partition.h
+ * @brief Divides an integral into pieces of roughly equal work for parallel threads
+ * A cheap pilot run of a globally adaptive 15 point Gauss-Kronrod rule bisects
+ * wherever the function is hardest, so its intervals crowd around singularities and
+ * steep regions. Each piece is then given the same number of pilot intervals, which
+ * makes pieces narrow where an adaptive rule will do the most work. The locally
+ * adaptive rules instead start from the pilot intervals themselves, keeping the
+ * integrals of those which already meet their goal (see pilotStarts()).
+ * @author Irene Crowell
+ */
+#ifndef PARTITION_H_
+#define PARTITION_H_
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <vector>
+#include "AdvancedRules/GaussKronrod.h"
+#include "PartialSum.h"
+
+/**
+ * The number of pilot intervals for each piece of balancedPartition()
+ */
+const int PILOT_INTERVALS_PER_PIECE = 8;
+/**
+ * The number of points of the pilot's rule (GaussKronrod::GK15)
+ */
+const int PILOT_POINTS = 15;
+
+/**
+ * An interval of the pilot run, with the error of its 15 point Gauss-Kronrod rule
+ */
+struct pilotInterval {
+	double a; //!<the left (starting) point of the interval
+	double b; //!<the right (ending) point of the interval
+	double result; //!<the interval's integral
+	double error; //!<the estimated error of the interval's integral
+	/**
+	 * Orders intervals by error, then width, so the heap's top is the worst
+	 * interval (or the widest, where the errors are only rounding)
+	 * @param other the interval to compare with
+	 * @return true if this interval has the smaller error
+	 */
+	bool operator<(const pilotInterval &other) const {
+		if (error != other.error)
+			return error < other.error;
+		return b - a < other.b - other.a;
+	}
+};
+
+/**
+ * Integrates a pilot interval with the 15 point Gauss-Kronrod rule.
+ * Intervals whose values are not finite are given the largest error, and those
+ * whose error is only rounding are given none.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the interval
+ * @param b the right (ending) point of the interval
+ * @return the interval
+ */
+template<typename Function>
+pilotInterval pilotIntegrate(const Function &f, double a, double b) {
+	GaussKronrod::panelResult panel = GaussKronrod::panel(f, a, b,
+	      GaussKronrod::GK15);
+	double error = panel.abserr;
+	if (!(fabs(panel.result) <= DBL_MAX) || !(error <= DBL_MAX))
+		error = DBL_MAX;
+	else if (error <= 100 * DBL_EPSILON * panel.resabs)
+		error = 0; // only rounding, so no harder than any other such interval
+	return {a, b, panel.result, error};
+}
+
+/**
+ * Runs the pilot for [a,b]: bisects the interval with the largest error until there
+ * are PILOT_INTERVALS_PER_PIECE intervals for each piece, or until every interval
+ * meets the goal (leaving at least one interval for each piece, unless they become
+ * too narrow to bisect).
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param pieces the number of pieces
+ * @param [out] evaluations the number of function evaluations the pilot made
+ * (may be NULL)
+ * @param goal the error goal for each unit of width (0 to stop only when every
+ * error is rounding)
+ * @return the pilot intervals, from left to right
+ */
+template<typename Function>
+std::vector<pilotInterval> pilotIntervals(const Function &f, double a,
+      double b, int pieces, long *evaluations = NULL, double goal = 0) {
+	std::vector<pilotInterval> intervals; // a heap, worst first
+	intervals.push_back(pilotIntegrate(f, a, b));
+	long integrated = 1;
+	double min_width = fabs(b - a) * DBL_EPSILON; // narrower intervals are not divided
+	double narrowest = fabs(b - a);
+	while ((int) intervals.size() < pieces * PILOT_INTERVALS_PER_PIECE) {
+		std::pop_heap(intervals.begin(), intervals.end());
+		pilotInterval worst = intervals.back();
+		// when every interval meets the goal, bisecting cannot balance any better
+		if (fabs(worst.b - worst.a) < 2 * min_width
+		      || (worst.error <= goal * narrowest
+		            && (int) intervals.size() >= pieces)) {
+			std::push_heap(intervals.begin(), intervals.end());
+			break;
+		}
+		double mid = 0.5 * (worst.a + worst.b);
+		narrowest = std::min(narrowest, 0.5 * fabs(worst.b - worst.a));
+		intervals.back() = pilotIntegrate(f, worst.a, mid);
+		std::push_heap(intervals.begin(), intervals.end());
+		intervals.push_back(pilotIntegrate(f, mid, worst.b));
+		std::push_heap(intervals.begin(), intervals.end());
+		integrated += 2;
+	}
+	if (evaluations)
+		(*evaluations) = integrated * PILOT_POINTS;
+
+	std::sort(intervals.begin(), intervals.end(),
+	      [](const pilotInterval &left, const pilotInterval &right) {
+		      return left.a < right.a;
+	      });
+	return intervals;
+}
+
+/**
+ * Runs the pilot for [a,b] (see pilotIntervals())
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param pieces the number of pieces
+ * @param [out] evaluations the number of function evaluations the pilot made
+ * (may be NULL)
+ * @return the points dividing the pilot intervals, from a to b
+ */
+template<typename Function>
+std::vector<double> pilotPoints(const Function &f, double a, double b,
+      int pieces, long *evaluations = NULL) {
+	std::vector<pilotInterval> intervals = pilotIntervals(f, a, b, pieces,
+	      evaluations);
+	std::vector<double> points(intervals.size() + 1);
+	for (size_t i = 0; i < intervals.size(); i++) {
+		points[i] = intervals[i].a;
+	}
+	points.front() = a;
+	points.back() = b;
+	return points;
+}
+
+/**
+ * Runs the pilot for [a,b] (see pilotIntervals()) for a locally adaptive rule's
+ * threads to start from, keeping its integrals: each pilot interval whose error
+ * already meets the goal is finished, and the rule only starts from the rest.
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param pieces the number of threads
+ * @param goal the error goal for each unit of width
+ * @param [out] finished the sum of the finished intervals' integrals, and the
+ * evaluations the pilot made
+ * @param [out] count the number of finished intervals
+ * @return the unfinished pilot intervals, from left to right
+ */
+template<typename Function>
+std::vector<pilotInterval> pilotStarts(const Function &f, double a, double b,
+      int pieces, double goal, partialSum *finished, int *count) {
+	std::vector<pilotInterval> starts;
+	(*finished) = partialSum();
+	(*count) = 0;
+	for (const pilotInterval &pilot : pilotIntervals(f, a, b, pieces,
+	      &finished->evaluations, goal)) {
+		if (pilot.error <= goal * fabs(pilot.b - pilot.a)) {
+			finished->value += pilot.result;
+			(*count)++;
+		} else {
+			starts.push_back(pilot);
+		}
+	}
+	return starts;
+}
+
+/**
+ * Divides [a,b] into pieces which should take an adaptive rule roughly equal work.
+ * Each piece takes the same number of consecutive pilot intervals (see
+ * pilotPoints()), so there are fewer pieces if the pilot has fewer intervals. The
+ * pilot only pays for itself when the pieces' work depends on the function, so
+ * rules of a fixed cost should use equal pieces, and the locally adaptive rules
+ * start from the pilot intervals themselves (see pilotStarts()).
+ * @param f the function to integrate (a batchFunction or a callable)
+ * @param a the left (starting) point of the integral
+ * @param b the right (ending) point of the integral
+ * @param pieces the number of pieces
+ * @param [out] evaluations the number of function evaluations the pilot made
+ * (may be NULL)
+ * @return the points dividing the pieces (at most pieces+1), from a to b
+ */
+template<typename Function>
+std::vector<double> balancedPartition(const Function &f, double a, double b,
+      int pieces, long *evaluations = NULL) {
+	std::vector<double> pilot = pilotPoints(f, a, b, pieces, evaluations);
+	long count = pilot.size() - 1;
+	pieces = std::min<long>(pieces, count); // no piece is empty
+	std::vector<double> points(pieces + 1);
+	for (int p = 0; p <= pieces; p++) {
+		points[p] = pilot[count * p / pieces];
+	}
+	return points;
+}
+
+#endif /* PARTITION_H_ */
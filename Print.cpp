@@ -328,6 +328,7 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 	double error;
 	int time;
 	int subdivisions;
+	double utilization;
 
 	std::fstream file;
 	for (int i = 0; i < 2; i++) { //run two tests
@@ -343,7 +344,7 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 		}
 		file << "Error Goal: " << error;
 		file << ",max_subdivisions: " << max_subdivisions << "\n";
-		file << ",Type,Integral,Result,Error,Time,Subdivisions\n";
+		file << ",Type,Integral,Result,Error,Time,Subdivisions,Utilization\n";
 		file << "Midpoint Rule:\n";
 		for (Functions::integrableFunction &function : functions.functions) {
 			std::cout << "Calculating " << function.name << "... " << std::flush;
@@ -353,11 +354,12 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 			std::clock_t start = std::clock();
 			double value = MidpointRule::adaptiveParallel(function.f, function.a,
 			      function.b, threads, error, max_subdivisions, time,
-			      &subdivisions);
+			      &subdivisions, &utilization);
 			double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 			file << "," << std::fixed << value;
 			file << "," << fabs(value - function.value);
-			file << "," << duration << "," << subdivisions << std::endl;
+			file << "," << duration << "," << subdivisions << "," << utilization
+			      << std::endl;
 			std::cout << "done." << std::endl;
 		}
 
@@ -370,11 +372,12 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 			std::clock_t start = std::clock();
 			double value = TrapezoidRule::adaptiveParallel(function.f, function.a,
 			      function.b, threads, error, max_subdivisions, time,
-			      &subdivisions);
+			      &subdivisions, &utilization);
 			double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 			file << "," << std::fixed << value;
 			file << "," << fabs(value - function.value);
-			file << "," << duration << "," << subdivisions << std::endl;
+			file << "," << duration << "," << subdivisions << "," << utilization
+			      << std::endl;
 			std::cout << "done." << std::endl;
 		}
 
@@ -387,11 +390,12 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 			std::clock_t start = std::clock();
 			double value = SimpsonRule::adaptiveParallel(function.f, function.a,
 			      function.b, threads, error, max_subdivisions, time,
-			      &subdivisions);
+			      &subdivisions, &utilization);
 			double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 			file << "," << std::fixed << value;
 			file << "," << fabs(value - function.value);
-			file << "," << duration << "," << subdivisions << std::endl;
+			file << "," << duration << "," << subdivisions << "," << utilization
+			      << std::endl;
 			std::cout << "done." << std::endl;
 		}
 
@@ -404,11 +408,12 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 			std::clock_t start = std::clock();
 			double value = Simpson38Rule::adaptiveParallel(function.f, function.a,
 			      function.b, threads, error, max_subdivisions, time,
-			      &subdivisions);
+			      &subdivisions, &utilization);
 			double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 			file << "," << std::fixed << value;
 			file << "," << fabs(value - function.value);
-			file << "," << duration << "," << subdivisions << std::endl;
+			file << "," << duration << "," << subdivisions << "," << utilization
+			      << std::endl;
 			std::cout << "done." << std::endl;
 		}
 
@@ -421,16 +426,93 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 			std::clock_t start = std::clock();
 			double value = BoolesRule::adaptiveParallel(function.f, function.a,
 			      function.b, threads, error, max_subdivisions, time,
-			      &subdivisions);
+			      &subdivisions, &utilization);
 			double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 			file << "," << std::fixed << value;
 			file << "," << fabs(value - function.value);
-			file << "," << duration << "," << subdivisions << std::endl;
+			file << "," << duration << "," << subdivisions << "," << utilization
+			      << std::endl;
 			std::cout << "done." << std::endl;
 		}
 		file.close();
 	}
 }
+void printAdaptiveGlobal(int max_subdivisions, int timeFast, int timeSlow,
+      double errorFast, double errorSlow, int threads) {
+	std::cout.precision(15);
+	Functions functions;
+	double error;
+	int time;
+	int subdivisions;
+	double abserror;
+
+	typedef double (*serialRule)(const batchFunction&, double, double, double,
+	      int, int, bool, int*, double*);
+	typedef double (*parallelRule)(const batchFunction&, double, double, int,
+	      double, int, int, bool, int*, double*);
+	const char *names[] = { "Midpoint Rule", "Trapezoid Rule", "Simpson Rule",
+	      "Simpson 3/8 Rule", "Boole's Rule" };
+	serialRule serialRules[] = { MidpointRule::adaptiveGlobalNonParallel,
+	      TrapezoidRule::adaptiveGlobalNonParallel,
+	      SimpsonRule::adaptiveGlobalNonParallel,
+	      Simpson38Rule::adaptiveGlobalNonParallel,
+	      BoolesRule::adaptiveGlobalNonParallel };
+	parallelRule parallelRules[] = { MidpointRule::adaptiveGlobalParallel,
+	      TrapezoidRule::adaptiveGlobalParallel,
+	      SimpsonRule::adaptiveGlobalParallel,
+	      Simpson38Rule::adaptiveGlobalParallel,
+	      BoolesRule::adaptiveGlobalParallel };
+
+	std::fstream file;
+	for (int i = 0; i < 2; i++) { //run two tests
+
+		if (i == 0) {
+			file.open("TestData/adaptiveGlobalFast.csv", std::fstream::out);
+			error = errorFast;
+			time = timeFast;
+		} else {
+			file.open("TestData/adaptiveGlobalAccurate.csv", std::fstream::out);
+			error = errorSlow;
+			time = timeSlow;
+		}
+		file << "Error Goal: " << error;
+		file << ",max_subdivisions: " << max_subdivisions << "\n";
+		file << ",Type,Integral,Result,Error,Time,Subdivisions,AbsError\n";
+		for (int rule = 0; rule < 5; rule++) {
+			for (int variant = 0; variant < 4; variant++) {
+				bool parallel = variant >= 2;
+				bool extrapolate = variant % 2 == 1;
+				file << "\n" << names[rule] << (parallel ? " (parallel" : " (serial")
+				      << (extrapolate ? ", extrapolated):\n" : "):\n");
+				for (Functions::integrableFunction &function : functions.functions) {
+					std::cout << "Calculating " << function.name << "... "
+					      << std::flush;
+					file << "," << std::defaultfloat << function.type << ","
+					      << function.name << " from " << function.a << " to "
+					      << function.b;
+					std::clock_t start = std::clock();
+					double value;
+					if (parallel)
+						value = parallelRules[rule](function.f, function.a,
+						      function.b, threads, error, max_subdivisions, time,
+						      extrapolate, &subdivisions, &abserror);
+					else
+						value = serialRules[rule](function.f, function.a,
+						      function.b, error, max_subdivisions, time, extrapolate,
+						      &subdivisions, &abserror);
+					double duration = (std::clock() - start)
+					      / (double) CLOCKS_PER_SEC;
+					file << "," << std::fixed << value;
+					file << "," << fabs(value - function.value);
+					file << "," << duration << "," << subdivisions << ","
+					      << abserror << std::endl;
+					std::cout << "done." << std::endl;
+				}
+			}
+		}
+		file.close();
+	}
+}
 /**
  * Checks if the error code is actually an error (not empty etc.)
  * @param error_code the error code to check
@@ -495,13 +577,40 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 				}
 				break;
 
+			case AdvancedRules::algorithm::a_clenshawCurtis:
+				file << "clenshawCurtis:\n";
+				for (Functions::integrableFunction &function : functions.functions) {
+					std::cout << "Calculating " << function.name << "... "
+					      << std::flush;
+					batchFunction batch(function.batch, function.f.params,
+					      function.f);
+					start = std::clock();
+					value = AdvancedRules::clenshawCurtis(&error_code, batch,
+					      function.a, function.b, error, max_subdivisions, &abserror);
+					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+					file << "," << std::defaultfloat << function.type << ","
+					      << function.name << " from " << function.a << " to "
+					      << function.b << std::fixed << value;
+					if (checkError(error_code)) {
+						file << "," << error_code << "," << "," << duration
+						      << std::endl;
+						error_code = "";
+					} else {
+						file << "," << value;
+						file << "," << fabs(value - function.value);
+						file << "," << duration << "," << abserror << std::endl;
+					}
+					std::cout << "done." << std::endl;
+				}
+				break;
+
 			case AdvancedRules::algorithm::a_nonAdaptiveGaussKronrod:
 				file << "nonAdaptiveGaussKronrod:\n";
 				for (Functions::integrableFunction &function : functions.functions) {
 					std::cout << "Calculating " << function.name << "... "
 					      << std::flush;
 					start = std::clock();
-					value = AdvancedRules::nonAdaptiveGaussKronrod(error_code,
+					value = AdvancedRules::nonAdaptiveGaussKronrod(&error_code,
 					      function.f, function.a, function.b, error, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 					file << "," << std::defaultfloat << function.type << ","
@@ -545,7 +654,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					      << std::flush;
 					start = std::clock();
 					value = AdvancedRules::nonAdaptiveGaussKronrodParallel(
-					      error_code, function.f, function.a, function.b, error,
+					      &error_code, function.f, function.a, function.b, error,
 					      threads, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 					file << "," << std::defaultfloat << function.type << ","
@@ -570,7 +679,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					std::cout << "Calculating " << function.name << "... "
 					      << std::flush;
 					start = std::clock();
-					value = AdvancedRules::adaptiveGaussKronrod(error_code,
+					value = AdvancedRules::adaptiveGaussKronrod(&error_code,
 					      function.f, function.a, function.b, error,
 					      max_subdivisions, key, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
@@ -596,7 +705,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					std::cout << "Calculating " << function.name << "... "
 					      << std::flush;
 					start = std::clock();
-					value = AdvancedRules::adaptiveGaussKronrodSingular(error_code,
+					value = AdvancedRules::adaptiveGaussKronrodSingular(&error_code,
 					      function.f, function.a, function.b, error,
 					      max_subdivisions, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
@@ -622,7 +731,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					      << std::flush;
 					start = std::clock();
 					value = AdvancedRules::adaptiveGaussKronrodKnownSingular(
-					      error_code, function.f, function.a, function.b, error,
+					      &error_code, function.f, function.a, function.b, error,
 					      max_subdivisions, function.singularity, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 					file << "," << std::defaultfloat << function.type << ","
@@ -647,7 +756,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					std::cout << "Calculating " << function.name << "... "
 					      << std::flush;
 					start = std::clock();
-					value = AdvancedRules::adaptiveGaussKronrodParallel(error_code,
+					value = AdvancedRules::adaptiveGaussKronrodParallel(&error_code,
 					      function.f, function.a, function.b, error,
 					      max_subdivisions, key, threads, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
@@ -673,7 +782,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					      << std::flush;
 					start = std::clock();
 					value = AdvancedRules::adaptiveGaussKronrodSingularParallel(
-					      error_code, function.f, function.a, function.b, error,
+					      &error_code, function.f, function.a, function.b, error,
 					      max_subdivisions, threads, &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
 					file << "," << std::defaultfloat << function.type << ","
@@ -698,7 +807,7 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 					      << std::flush;
 					start = std::clock();
 					value = AdvancedRules::adaptiveGaussKronrodKnownSingularParallel(
-					      error_code, function.f, function.a, function.b, error,
+					      &error_code, function.f, function.a, function.b, error,
 					      max_subdivisions, function.singularity, threads,
 					      &abserror);
 					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
@@ -719,6 +828,60 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 				}
 				break;
 
+			case AdvancedRules::algorithm::a_tanhSinh:
+				file << "tanhSinh:\n";
+				for (Functions::integrableFunction &function : functions.functions) {
+					std::cout << "Calculating " << function.name << "... "
+					      << std::flush;
+					batchFunction batch(function.batch, function.f.params,
+					      function.f);
+					start = std::clock();
+					value = AdvancedRules::tanhSinh(&error_code, batch, function.a,
+					      function.b, error, TanhSinh::MAX_LEVEL, &abserror);
+					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+					file << "," << std::defaultfloat << function.type << ","
+					      << function.name << " from " << function.a << " to "
+					      << function.b << std::fixed << value;
+					if (checkError(error_code)) {
+						file << "," << error_code << "," << "," << duration
+						      << std::endl;
+						error_code = "";
+					} else {
+						file << "," << value;
+						file << "," << fabs(value - function.value);
+						file << "," << duration << "," << abserror << std::endl;
+					}
+					std::cout << "done." << std::endl;
+				}
+				break;
+
+			case AdvancedRules::algorithm::a_tanhSinhParallel:
+				file << "tanhSinhParallel:\n";
+				for (Functions::integrableFunction &function : functions.functions) {
+					std::cout << "Calculating " << function.name << "... "
+					      << std::flush;
+					batchFunction batch(function.batch, function.f.params,
+					      function.f);
+					start = std::clock();
+					value = AdvancedRules::tanhSinhParallel(&error_code, batch, function.a,
+					      function.b, error, TanhSinh::MAX_LEVEL, threads, &abserror);
+					duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+					file << "," << std::defaultfloat << function.type << ","
+					      << function.name << " from " << function.a << " to "
+					      << function.b << std::fixed << value;
+					if (checkError(error_code)) {
+						file << "," << error_code << "," << "," << duration
+						      << std::endl;
+						error_code = "";
+					} else {
+						file << "," << value;
+						file << "," << fabs(value - function.value);
+						file << "," << duration << "," << abserror << std::endl;
+					}
+					std::cout << "done." << std::endl;
+				}
+				break;
+
 			}
 
 		}
@@ -726,3 +889,1098 @@ void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
 	}
 }
 
+
+void printThreadPool(int subdivisions, int threads, int repetitions) {
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/threadPool.csv", std::fstream::out);
+
+	typedef double (*parallelRule)(const batchFunction&, double, double, int,
+	      int);
+	const char *names[] = { "Midpoint Rule", "Trapezoid Rule", "Simpson Rule",
+	      "Simpson 3/8 Rule", "Boole's Rule", "gaussLegendreFixedParallel" };
+	parallelRule rules[] = { MidpointRule::nonAdaptiveParallel,
+	      TrapezoidRule::nonAdaptiveParallel, SimpsonRule::nonAdaptiveParallel,
+	      Simpson38Rule::nonAdaptiveParallel, BoolesRule::nonAdaptiveParallel,
+	      [](const batchFunction &f, double a, double b, int points, int threads) {
+		      return AdvancedRules::gaussLegendreFixedParallel(f.scalar, a, b,
+		            points, threads);
+	      } };
+
+	file << "Subdivisions: " << subdivisions << ",Threads: " << threads
+	      << ",Repetitions: " << repetitions << "\n";
+	file << ",Rule,Pooled Latency (us),Spawned Latency (us),Speedup\n";
+	ThreadPool::getInstance().reserve(threads);
+	for (int rule = 0; rule < 6; rule++) {
+		std::cout << "Timing " << names[rule] << "... " << std::flush;
+		double latency[2];
+		for (int pooled = 0; pooled < 2; pooled++) {
+			ThreadPool::setPooling(pooled == 0);
+			std::chrono::steady_clock::time_point start =
+			      std::chrono::steady_clock::now();
+			for (int i = 0; i < repetitions; i++) {
+				for (Functions::integrableFunction &function : functions.functions) {
+					rules[rule](function.f, function.a, function.b, subdivisions,
+					      threads);
+				}
+			}
+			std::chrono::duration<double, std::micro> duration =
+			      std::chrono::steady_clock::now() - start;
+			latency[pooled] = duration.count()
+			      / (repetitions * functions.functions.size());
+		}
+		file << "," << names[rule] << "," << std::fixed << latency[0] << ","
+		      << latency[1] << "," << latency[1] / latency[0] << std::endl;
+		std::cout << "done." << std::endl;
+	}
+	ThreadPool::setPooling(true);
+	file.close();
+}
+
+void printVectorFunctions(int subdivisions, int points, int repetitions) {
+	std::cout.precision(15);
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/vectorFunctions.csv", std::fstream::out);
+
+	file << "Subdivisions: " << subdivisions << ",Points: " << points
+	      << ",Repetitions: " << repetitions << "\n";
+	file << ",Type,Integral,Scalar Result,Batch Result,Scalar Error,"
+	      << "Batch Error,Max Relative Difference,Scalar (evals/s),"
+	      << "Batch (evals/s),Speedup\n";
+	std::vector<double> x(points);
+	std::vector<double> fx(points);
+	for (Functions::integrableFunction &function : functions.functions) {
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		file << "," << std::defaultfloat << function.type << "," << function.name
+		      << " from " << function.a << " to " << function.b;
+		batchFunction batch(function.batch, function.f.params, function.f);
+
+		//accuracy, against the symbolic value and point by point against the scalar version
+		double scalarValue = BoolesRule::nonAdaptiveNonParallel(function.f,
+		      function.a, function.b, subdivisions);
+		double batchValue = BoolesRule::nonAdaptiveNonParallel(batch, function.a,
+		      function.b, subdivisions);
+		double width = (function.b - function.a) / points;
+		for (int i = 0; i < points; i++) {
+			x[i] = function.a + (i + 0.5) * width;
+		}
+		function.batch(x.data(), fx.data(), points, function.f.params);
+		double difference = 0;
+		for (int i = 0; i < points; i++) {
+			double scalar = function.f.function(x[i], function.f.params);
+			if (!std::isfinite(scalar) || fabs(scalar) < DBL_MIN)
+				continue; // relative difference is meaningless for singular or underflowing values
+			difference = fmax(difference, fabs((fx[i] - scalar) / scalar));
+		}
+
+		//throughput, over the same points in blocks of BATCH_SIZE
+		double rate[2];
+		for (int batched = 0; batched < 2; batched++) {
+			std::chrono::steady_clock::time_point start =
+			      std::chrono::steady_clock::now();
+			for (int repetition = 0; repetition < repetitions; repetition++) {
+				for (int i = 0; i < points; i += BATCH_SIZE) {
+					int count = std::min(BATCH_SIZE, points - i);
+					if (batched) {
+						function.batch(&x[i], &fx[i], count, function.f.params);
+					} else {
+						for (int j = i; j < i + count; j++) {
+							fx[j] = function.f.function(x[j], function.f.params);
+						}
+					}
+				}
+			}
+			std::chrono::duration<double> duration =
+			      std::chrono::steady_clock::now() - start;
+			rate[batched] = (double) points * repetitions / duration.count();
+		}
+
+		file << "," << std::fixed << scalarValue << "," << batchValue;
+		file << "," << fabs(scalarValue - function.value) << ","
+		      << fabs(batchValue - function.value);
+		file << "," << std::scientific << difference << "," << rate[0] << ","
+		      << rate[1] << "," << std::fixed << rate[1] / rate[0] << std::endl;
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+/**
+ * Times a single integration
+ * @param integrate the integration to run, called with f
+ * @param f the function to integrate
+ * @param [out] seconds the time taken
+ * @return the numerically integrated value
+ */
+template<typename Integrate, typename Function>
+double timeIntegral(const Integrate &integrate, const Function &f,
+      double *seconds) {
+	std::chrono::steady_clock::time_point start =
+	      std::chrono::steady_clock::now();
+	double result = integrate(f);
+	std::chrono::duration<double> duration = std::chrono::steady_clock::now()
+	      - start;
+	(*seconds) = duration.count();
+	return result;
+}
+
+void printCallableFunctions(int subdivisions, int threads) {
+	std::cout.precision(15);
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/callableFunctions.csv", std::fstream::out);
+
+	file << "Subdivisions: " << subdivisions << ",Threads: " << threads << "\n";
+	file << ",Rule,Integral,gsl_function Result,Callable Result,"
+	      << "gsl_function (s),batchFunction (s),Callable (s),"
+	      << "Speedup over gsl_function,Speedup over batchFunction\n";
+	// functions 1 and 4 as lambdas, written as their batch versions are
+	auto square = [](double x) {return x * x;};
+	auto polynomial4 = [](double x) {
+		return (((3 * x + 4) * x + 76) * x + 58) * x + 4;
+	};
+	for (int index : { 1, 4 }) {
+		Functions::integrableFunction &function = functions.functions[index];
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		auto compare = [&](const char *name, auto integrate) {
+			std::cout << "Timing " << name << " on " << function.name << "... "
+			      << std::flush;
+			double seconds[3];
+			double gslValue = timeIntegral(integrate, function.f, &seconds[0]);
+			timeIntegral(integrate, batch, &seconds[1]);
+			double callableValue = index == 1 ?
+			      timeIntegral(integrate, square, &seconds[2]) :
+			      timeIntegral(integrate, polynomial4, &seconds[2]);
+			file << "," << name << "," << function.name << " from " << a << " to "
+			      << b << "," << std::fixed << gslValue << "," << callableValue << ","
+			      << seconds[0] << "," << seconds[1] << "," << seconds[2] << ","
+			      << seconds[0] / seconds[2] << "," << seconds[1] / seconds[2]
+			      << std::defaultfloat << std::endl;
+			std::cout << "done." << std::endl;
+		};
+		compare("Simpson Rule", [&](const auto &f) {
+			return SimpsonRule::nonAdaptiveNonParallel(f, a, b, subdivisions);
+		});
+		compare("Boole's Rule", [&](const auto &f) {
+			return BoolesRule::nonAdaptiveNonParallel(f, a, b, subdivisions);
+		});
+		compare("Boole's Rule (parallel)", [&](const auto &f) {
+			return BoolesRule::nonAdaptiveParallel(f, a, b, subdivisions, threads);
+		});
+	}
+	file.close();
+}
+
+void printEvaluationPolicy(int subdivisions, int repetitions) {
+	std::cout.precision(15);
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/evaluationPolicy.csv", std::fstream::out);
+
+	file << "Subdivisions: " << subdivisions << ",Repetitions: " << repetitions
+	      << "\n";
+	file << ",Type,Integral,Well Behaved,Deferred Repair Result,Unchecked Result,"
+	      << "Repaired Values,Repair Evaluations,Deferred Repair (s),"
+	      << "Unchecked (s),Speedup\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		file << "," << function.type << "," << function.name << " from " << a
+		      << " to " << b << "," << (function.wellBehaved ? "yes" : "no");
+
+		double seconds[2] = { 0, 0 };
+		double result[2] = { 0, 0 };
+		repairStatistics &statistics = repairStatistics::getInstance();
+		statistics.reset();
+		for (int i = 0; i < repetitions; i++) {
+			double time;
+			result[0] = timeIntegral([&](const batchFunction &f) {
+				return BoolesRule::nonAdaptiveNonParallel<deferredRepair>(f, a, b,
+				      subdivisions);
+			}, batch, &time);
+			seconds[0] += time;
+		}
+		long repaired = statistics.repaired / repetitions;
+		long evaluations = statistics.evaluations / repetitions;
+		if (function.wellBehaved) { // the unchecked policy is only safe for these
+			for (int i = 0; i < repetitions; i++) {
+				double time;
+				result[1] = timeIntegral([&](const batchFunction &f) {
+					return BoolesRule::nonAdaptiveNonParallel<unchecked>(f, a, b,
+					      subdivisions);
+				}, batch, &time);
+				seconds[1] += time;
+			}
+		}
+
+		file << "," << std::fixed << result[0] << ",";
+		if (function.wellBehaved)
+			file << result[1];
+		file << "," << repaired << "," << evaluations << "," << seconds[0] << ",";
+		if (function.wellBehaved)
+			file << seconds[1] << "," << seconds[0] / seconds[1];
+		else
+			file << ",";
+		file << std::defaultfloat << std::endl;
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printGaussLegendreCache(int pointsFast, int pointsSlow, int threads,
+      int repetitions) {
+	std::cout.precision(15);
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/gaussLegendreCache.csv", std::fstream::out);
+
+	file << "Threads: " << threads << ",Repetitions: " << repetitions << "\n";
+	file << ",Integral,Points,Uncached Latency (us),Cached Latency (us),"
+	      << "Speedup\n";
+	for (int points : { pointsFast, pointsSlow }) {
+		for (Functions::integrableFunction &function : functions.functions) {
+			std::cout << "Timing " << function.name << " with " << points
+			      << " points... " << std::flush;
+			double latency[2];
+			for (int cached = 0; cached < 2; cached++) {
+				std::chrono::steady_clock::time_point start =
+				      std::chrono::steady_clock::now();
+				for (int i = 0; i < repetitions; i++) {
+					if (cached) {
+						AdvancedRules::gaussLegendreFixed(function.f, function.a,
+						      function.b, points);
+					} else { // computing the table on every call, as gsl does
+						gsl_integration_glfixed_table *table =
+						      gsl_integration_glfixed_table_alloc(points);
+						gsl_integration_glfixed(&function.f, function.a, function.b,
+						      table);
+						gsl_integration_glfixed_table_free(table);
+					}
+				}
+				std::chrono::duration<double, std::micro> duration =
+				      std::chrono::steady_clock::now() - start;
+				latency[cached] = duration.count() / repetitions;
+			}
+			file << "," << function.name << "," << points << "," << std::fixed
+			      << latency[0] << "," << latency[1] << ","
+			      << latency[0] / latency[1] << std::defaultfloat << std::endl;
+			std::cout << "done." << std::endl;
+		}
+	}
+
+	//the composite parallel rule, which must agree for any number of threads
+	file << "\n,Integral,Points,Threads,Parallel Result,Parallel Error\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		for (int t = 1; t <= threads; t++) {
+			double value = AdvancedRules::gaussLegendreFixedParallel(function.f,
+			      function.a, function.b, pointsSlow, t);
+			file << "," << function.name << "," << pointsSlow << "," << t << ","
+			      << std::fixed << value << "," << std::scientific
+			      << fabs(value - function.value) << std::defaultfloat << std::endl;
+		}
+	}
+	file.close();
+}
+
+void printWorkspacePool(int max_subdivisions, double error, int integrals) {
+	gsl_set_error_handler_off();
+	const char * error_code = "";
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/workspacePool.csv", std::fstream::out);
+
+	file << "Max Subdivisions: " << max_subdivisions << ",Error: " << error
+	      << ",Integrals: " << integrals << "\n";
+	file << ",Rule,Allocated (integrals/s),Pooled (integrals/s),Speedup\n";
+	const char *names[] = { "adaptiveGaussKronrod (qag)",
+	      "adaptiveGaussKronrodSingular (qags)" };
+	for (int rule = 0; rule < 2; rule++) {
+		std::cout << "Timing " << names[rule] << "... " << std::flush;
+		double rate[2];
+		for (int pooled = 0; pooled < 2; pooled++) {
+			std::chrono::steady_clock::time_point start =
+			      std::chrono::steady_clock::now();
+			for (int i = 0; i < integrals; i++) {
+				int index = i % functions.functions.size(); // cycling through the functions
+				Functions::integrableFunction &function = functions.functions[index];
+				double abserror;
+				if (pooled && rule == 0) {
+					AdvancedRules::adaptiveGaussKronrod(&error_code, function.f,
+					      function.a, function.b, error, max_subdivisions,
+					      GSL_INTEG_GAUSS21, &abserror);
+				} else if (pooled) {
+					AdvancedRules::adaptiveGaussKronrodSingular(&error_code,
+					      function.f, function.a, function.b, error,
+					      max_subdivisions, &abserror);
+				} else { // allocating the workspace for every integral
+					double result;
+					gsl_integration_workspace *workspace =
+					      gsl_integration_workspace_alloc(max_subdivisions);
+					if (rule == 0) {
+						gsl_integration_qag(&function.f, function.a, function.b,
+						      error, error, max_subdivisions, GSL_INTEG_GAUSS21,
+						      workspace, &result, &abserror);
+					} else {
+						gsl_integration_qags(&function.f, function.a, function.b,
+						      error, error, max_subdivisions, workspace, &result,
+						      &abserror);
+					}
+					gsl_integration_workspace_free(workspace);
+				}
+			}
+			std::chrono::duration<double> duration =
+			      std::chrono::steady_clock::now() - start;
+			rate[pooled] = integrals / duration.count();
+		}
+		file << "," << names[rule] << "," << std::fixed << rate[0] << ","
+		      << rate[1] << "," << rate[1] / rate[0] << std::defaultfloat
+		      << std::endl;
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printGaussKronrodKernels(int panels) {
+	std::cout.precision(15);
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/gaussKronrodKernels.csv", std::fstream::out);
+
+	file << "Panels: " << panels << "\n";
+	file << ",Rule,Integral,GSL Result,Native Result,Difference,GSL Error,"
+	      << "Native Error,GSL (ns/panel),Native (ns/panel),Speedup\n";
+	typedef void (*qk)(const gsl_function *f, double a, double b,
+	      double *result, double *abserr, double *resabs, double *resasc);
+	const qk rules[] = { gsl_integration_qk15, gsl_integration_qk21,
+	      gsl_integration_qk31, gsl_integration_qk41, gsl_integration_qk51,
+	      gsl_integration_qk61 };
+	for (int key = GSL_INTEG_GAUSS15; key <= GSL_INTEG_GAUSS61; key++) {
+		std::cout << "Timing GK" << GaussKronrod::points(key) << "... "
+		      << std::flush;
+		for (Functions::integrableFunction &function : functions.functions) {
+			batchFunction batch(function.batch, function.f.params, function.f);
+			double a = function.a;
+			double b = function.b;
+			double width = (b - a) / panels;
+			double gslError = 0;
+			double seconds[2];
+			double gslValue = timeIntegral([&](const gsl_function &f) {
+				double sum = 0;
+				for (int j = 0; j < panels; j++) {
+					double result, abserr, resabs, resasc;
+					rules[key - 1](&f, a + j * width,
+					      j == panels - 1 ? b : a + (j + 1) * width, &result,
+					      &abserr, &resabs, &resasc);
+					sum += result;
+					gslError += abserr;
+				}
+				return sum;
+			}, function.f, &seconds[0]);
+			double nativeError;
+			double nativeValue = timeIntegral([&](const batchFunction &f) {
+				return AdvancedRules::gaussKronrodFixed(f, a, b, key, panels,
+				      &nativeError);
+			}, batch, &seconds[1]);
+			file << ",GK" << GaussKronrod::points(key) << "," << function.name
+			      << " from " << a << " to " << b << "," << gslValue << ","
+			      << nativeValue << "," << std::scientific
+			      << fabs(gslValue - nativeValue) << "," << gslError << ","
+			      << nativeError << std::fixed << "," << 1e9 * seconds[0] / panels
+			      << "," << 1e9 * seconds[1] / panels << ","
+			      << seconds[0] / seconds[1] << std::defaultfloat << std::endl;
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printParallelGaussKronrod(double error, int max_subdivisions, int threads) {
+	gsl_set_error_handler_off();
+	std::cout.precision(15);
+	const char * error_code = "";
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/parallelGaussKronrod.csv", std::fstream::out);
+
+	file << "Error: " << error << ",Max Subdivisions: " << max_subdivisions
+	      << ",Threads: " << threads << "\n";
+	file << ",Rule,Integral,Threads,Result,Actual Error,Estimated Error,"
+	      << "Time (s)\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		if (function.type != "badly behaved")
+			continue;
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		auto print = [&](const char *name, int num_threads, auto integrate) {
+			double abserror;
+			std::chrono::steady_clock::time_point start =
+			      std::chrono::steady_clock::now();
+			double value = integrate(&abserror);
+			std::chrono::duration<double> duration =
+			      std::chrono::steady_clock::now() - start;
+			file << "," << name << "," << function.name << " from " << a << " to "
+			      << b << "," << num_threads << "," << std::fixed << value << ","
+			      << std::scientific << fabs(value - function.value) << ","
+			      << abserror << std::fixed << "," << duration.count()
+			      << std::defaultfloat << std::endl;
+		};
+		print("GSL qag", 1, [&](double *abserror) {
+			return AdvancedRules::adaptiveGaussKronrod(&error_code, function.f, a,
+			      b, error, max_subdivisions, GSL_INTEG_GAUSS21, abserror);
+		});
+		print("GSL qags", 1, [&](double *abserror) {
+			return AdvancedRules::adaptiveGaussKronrodSingular(&error_code,
+			      function.f, a, b, error, max_subdivisions, abserror);
+		});
+		for (int num_threads : { 1, threads }) {
+			print("Global GK21", num_threads, [&](double *abserror) {
+				return AdvancedRules::adaptiveGaussKronrodParallel(&error_code,
+				      batch, a, b, error, max_subdivisions, GSL_INTEG_GAUSS21,
+				      num_threads, abserror);
+			});
+			print("Global GK21 + epsilon", num_threads, [&](double *abserror) {
+				return AdvancedRules::adaptiveGaussKronrodSingularParallel(
+				      &error_code, batch, a, b, error, max_subdivisions, num_threads,
+				      abserror);
+			});
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printPartitionBalance(double error, int max_subdivisions, int threads) {
+	std::cout.precision(15);
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/partitionBalance.csv", std::fstream::out);
+
+	file << "Error: " << error << ",Max Subdivisions: " << max_subdivisions
+	      << ",Pieces: " << threads << "\n";
+	file << ",Integral,Partition,Subdivisions of each piece,Imbalance\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		std::cout << "Partitioning " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		std::vector<double> equal(threads + 1);
+		for (int i = 0; i <= threads; i++) {
+			equal[i] = a + (b - a) * i / threads;
+		}
+		std::vector<double> balanced = balancedPartition(batch, a, b, threads);
+		for (int partition = 0; partition < 2; partition++) {
+			std::vector<double> &pieces = partition ? balanced : equal;
+			file << "," << function.name << " from " << a << " to " << b << ","
+			      << (partition ? "balanced" : "equal") << ",";
+			long total = 0;
+			long largest = 0;
+			for (int i = 0; i + 1 < (int) pieces.size(); i++) {
+				const char *error_code = "";
+				double abserror;
+				int subdivisions;
+				AdvancedRules::globalGaussKronrod(&error_code, batch, pieces[i],
+				      pieces[i + 1], error / threads, max_subdivisions,
+				      GSL_INTEG_GAUSS21, 1, false, &abserror, &subdivisions);
+				file << (i ? " " : "") << subdivisions;
+				total += subdivisions;
+				largest = std::max<long>(largest, subdivisions);
+			}
+			file << "," << std::fixed << largest * threads / (double) total
+			      << std::defaultfloat << std::endl;
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printClenshawCurtis(double error, int max_points) {
+	const char * error_code = "";
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/clenshawCurtis.csv", std::fstream::out);
+
+	file << "Error: " << error << ",Max Points: " << max_points << "\n";
+	file << "Gauss-Legendre and Boole's Rule double their points until the goal is "
+	      << "met; their evaluations and time are summed over every try\n";
+	file << ",Rule,Integral,Result,Actual Error,Evaluations,Time (s)\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		if (function.type != "simple")
+			continue;
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		double goal = std::max(error, error * fabs(function.value));
+		auto print = [&](const char *name, double value, long evaluations,
+		      double seconds) {
+			file << "," << name << "," << function.name << " from " << a << " to "
+			      << b << "," << std::fixed << value << "," << std::scientific
+			      << fabs(value - function.value) << "," << std::defaultfloat
+			      << evaluations << "," << std::fixed << seconds
+			      << std::defaultfloat << std::endl;
+		};
+		double seconds;
+		double abserror;
+		int evaluations;
+		double value = timeIntegral([&](const batchFunction &f) {
+			return AdvancedRules::clenshawCurtis(&error_code, f, a, b, error,
+			      max_points, &abserror, &evaluations);
+		}, batch, &seconds);
+		print("Clenshaw-Curtis", value, evaluations, seconds);
+
+		// doubling the points (or subdivisions) until the goal is reached, counting
+		// the evaluations and time of every try
+		int points = 1;
+		double total_seconds = 0;
+		long total_evaluations = 0;
+		do {
+			value = timeIntegral([&](const gsl_function &f) {
+				return AdvancedRules::gaussLegendreFixed(f, a, b, points);
+			}, function.f, &seconds);
+			total_seconds += seconds;
+			total_evaluations += points;
+		} while (fabs(value - function.value) > goal
+		      && (points *= 2) < max_points);
+		print("Gauss-Legendre", value, total_evaluations, total_seconds);
+
+		int subdivisions = 4;
+		total_seconds = 0;
+		total_evaluations = 0;
+		do {
+			value = timeIntegral([&](const batchFunction &f) {
+				return BoolesRule::nonAdaptiveNonParallel(f, a, b, subdivisions);
+			}, batch, &seconds);
+			total_seconds += seconds;
+			total_evaluations += 4L * subdivisions + 1;
+		} while (fabs(value - function.value) > goal
+		      && (subdivisions *= 2) < max_points);
+		print("Boole's Rule", value, total_evaluations, total_seconds);
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printGaussLegendreNodes(int max_points, int max_gsl_points, int threads) {
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/gaussLegendreNodes.csv", std::fstream::out);
+
+	file << "Max GSL Points: " << max_gsl_points << ",Threads: " << threads << "\n";
+	file << ",Points,GSL Time (s),Generated Time (s),Generated Time (" << threads
+	      << " threads) (s),Speedup,Max Node Difference,Max Weight Difference,"
+	      << "Max Simple Function Error\n";
+	for (long points = 1000; points <= max_points; points *= 10) {
+		std::cout << "Generating " << points << " points... " << std::flush;
+		double seconds[3];
+		gsl_integration_glfixed_table *tables[3] = { NULL, NULL, NULL };
+		for (int rule = 0; rule < 3; rule++) {
+			if (rule == 0 && points > max_gsl_points)
+				continue; // gsl's O(n^2) Newton iteration takes too long
+			std::chrono::steady_clock::time_point start =
+			      std::chrono::steady_clock::now();
+			tables[rule] = rule ? AdvancedRules::glfixedTableAlloc(points,
+			      rule == 1 ? 1 : threads) :
+			      gsl_integration_glfixed_table_alloc(points);
+			std::chrono::duration<double> duration =
+			      std::chrono::steady_clock::now() - start;
+			seconds[rule] = duration.count();
+		}
+
+		// the generated table against gsl's, and on the simple functions
+		double node_difference = 0;
+		double weight_difference = 0;
+		if (tables[0]) {
+			for (long i = 0; i < (points + 1) / 2; i++) {
+				node_difference = std::max(node_difference,
+				      fabs(tables[1]->x[i] - tables[0]->x[i]));
+				weight_difference = std::max(weight_difference,
+				      fabs(tables[1]->w[i] - tables[0]->w[i]) / tables[0]->w[i]);
+			}
+		}
+		double function_error = 0;
+		for (Functions::integrableFunction &function : functions.functions) {
+			if (function.type != "simple")
+				continue;
+			double value = gsl_integration_glfixed(&function.f, function.a,
+			      function.b, tables[2]);
+			function_error = std::max(function_error, fabs(value - function.value)
+			      / std::max(1.0, fabs(function.value)));
+		}
+
+		file << "," << points << ",";
+		if (tables[0])
+			file << std::fixed << seconds[0];
+		file << "," << std::fixed << seconds[1] << "," << seconds[2] << ",";
+		if (tables[0])
+			file << seconds[0] / seconds[2];
+		file << "," << std::scientific;
+		if (tables[0])
+			file << node_difference << "," << weight_difference;
+		else
+			file << ",";
+		file << "," << function_error << std::defaultfloat << std::endl;
+		for (gsl_integration_glfixed_table *table : tables) {
+			if (table)
+				gsl_integration_glfixed_table_free(table);
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printRomberg(double error, int max_subdivisions, int threads) {
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/romberg.csv", std::fstream::out);
+
+	file << "Error: " << error << ",Max Subdivisions: " << max_subdivisions
+	      << ",Threads: " << threads << "\n";
+	file << ",Rule,Integral,Result,Actual Error,Estimated Error,Evaluations,"
+	      << "Time (s)\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		auto print = [&](const char *name, double value, double abserror,
+		      long evaluations, double seconds) {
+			file << "," << name << "," << function.name << " from " << a << " to "
+			      << b << "," << std::fixed << value << "," << std::scientific
+			      << fabs(value - function.value) << ",";
+			if (abserror >= 0)
+				file << abserror;
+			file << "," << std::defaultfloat << evaluations << "," << std::fixed
+			      << seconds << std::defaultfloat << std::endl;
+		};
+		double seconds;
+		double abserror;
+		int subdivisions;
+		double value = 0;
+		for (int t : { 1, threads }) {
+			value = timeIntegral([&](const batchFunction &f) {
+				return TrapezoidRule::romberg(f, a, b, error, max_subdivisions, t,
+				      &subdivisions, &abserror);
+			}, batch, &seconds);
+			print(t == 1 ? "Romberg" : "Romberg (parallel)", value, abserror,
+			      subdivisions + 1, seconds);
+		}
+
+		// Boole's rule with its subdivisions doubled until it is as accurate
+		double goal = std::max(error, fabs(value - function.value));
+		int boole_subdivisions = 1;
+		while (true) {
+			value = timeIntegral([&](const batchFunction &f) {
+				return BoolesRule::nonAdaptiveNonParallel(f, a, b,
+				      boole_subdivisions);
+			}, batch, &seconds);
+			if (fabs(value - function.value) <= goal
+			      || 2 * boole_subdivisions > max_subdivisions)
+				break;
+			boole_subdivisions *= 2;
+		}
+		print("Boole's Rule", value, -1, 4L * boole_subdivisions + 1, seconds);
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+/**
+ * Prints several adaptive rules on every function, to a file: the result, its
+ * error, the time taken, the subdivisions and evaluations used, and (for the rules
+ * which report it) the threads' utilization
+ * @param path the file to write
+ * @param error the error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param threads the number of threads to run in parallel
+ * @param names the name of each rule
+ * @param integrate integrates with a rule: integrate(rule, f, a, b, &subdivisions,
+ * &utilization), where f is a batchFunction or a callable, and utilization may be
+ * left negative
+ */
+template<typename Integrate>
+void printAdaptiveRules(const char *path, double error, int max_subdivisions,
+      int threads, const std::vector<const char*> &names,
+      const Integrate &integrate) {
+	Functions functions;
+	std::fstream file;
+	file.open(path, std::fstream::out);
+
+	file << "Error Goal: " << error << ",max_subdivisions: " << max_subdivisions
+	      << ",Threads: " << threads << "\n";
+	file << ",Rule,Integral,Result,Error,Time (s),Subdivisions,Evaluations,"
+	      << "Evaluations per Subdivision,Utilization\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		std::atomic<long> evaluations;
+		auto counted = [&](double x) {
+			evaluations++;
+			return function.f.function(x, function.f.params);
+		};
+		double a = function.a;
+		double b = function.b;
+		for (size_t rule = 0; rule < names.size(); rule++) {
+			int subdivisions = 0;
+			double utilization = -1;
+			double seconds;
+			double value = timeIntegral([&](const batchFunction &f) {
+				return integrate(rule, f, a, b, &subdivisions, &utilization);
+			}, batch, &seconds);
+			evaluations = 0;
+			integrate(rule, counted, a, b, &subdivisions, &utilization);
+			file << "," << names[rule] << "," << function.name << " from " << a
+			      << " to " << b << "," << std::fixed << value << ","
+			      << std::scientific << fabs(value - function.value) << ","
+			      << std::fixed << seconds << "," << subdivisions << ","
+			      << evaluations << "," << evaluations / (double) subdivisions
+			      << ",";
+			if (utilization >= 0)
+				file << utilization;
+			file << std::defaultfloat << std::endl;
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printGaussLobatto(double error, int max_subdivisions, int max_time,
+      int threads) {
+	printAdaptiveRules("TestData/gaussLobatto.csv", error, max_subdivisions,
+	      threads, { "BoolesRule::adaptiveParallel", "adaptiveGaussLobatto",
+	            "adaptiveGaussLobattoParallel" }, [&](int rule, const auto &f,
+	            double a, double b, int *subdivisions, double *utilization) {
+		      switch (rule) {
+		      case 0:
+			      return BoolesRule::adaptiveParallel(f, a, b, threads, error,
+			            max_subdivisions, max_time, subdivisions, utilization);
+		      case 1:
+			      return GaussLobatto::adaptiveNonParallel<deferredRepair>(f, a, b,
+			            error, max_subdivisions, max_time, subdivisions);
+		      default:
+			      return GaussLobatto::adaptiveParallel<deferredRepair>(f, a, b,
+			            threads, error, max_subdivisions, max_time, subdivisions,
+			            utilization);
+		      }
+	      });
+}
+
+void printNestedAdaptive(double error, int max_subdivisions, int max_time,
+      int threads) {
+	printAdaptiveRules("TestData/nestedAdaptive.csv", error, max_subdivisions,
+	      threads, { "Simpson38Rule::adaptiveNonParallel",
+	            "Simpson38Rule::adaptiveNestedNonParallel",
+	            "Simpson38Rule::adaptiveNestedParallel",
+	            "BoolesRule::adaptiveNonParallel",
+	            "BoolesRule::adaptiveNestedNonParallel",
+	            "BoolesRule::adaptiveNestedParallel" }, [&](int rule,
+	            const auto &f, double a, double b, int *subdivisions,
+	            double *utilization) {
+		      switch (rule) {
+		      case 0:
+			      return Simpson38Rule::adaptiveNonParallel(f, a, b, error,
+			            max_subdivisions, max_time, subdivisions);
+		      case 1:
+			      return Simpson38Rule::adaptiveNestedNonParallel(f, a, b, error,
+			            max_subdivisions, max_time, subdivisions);
+		      case 2:
+			      return Simpson38Rule::adaptiveNestedParallel(f, a, b, threads,
+			            error, max_subdivisions, max_time, subdivisions,
+			            utilization);
+		      case 3:
+			      return BoolesRule::adaptiveNonParallel(f, a, b, error,
+			            max_subdivisions, max_time, subdivisions);
+		      case 4:
+			      return BoolesRule::adaptiveNestedNonParallel(f, a, b, error,
+			            max_subdivisions, max_time, subdivisions);
+		      default:
+			      return BoolesRule::adaptiveNestedParallel(f, a, b, threads,
+			            error, max_subdivisions, max_time, subdivisions,
+			            utilization);
+		      }
+	      });
+}
+
+void printHpAdaptive(double error, int max_subdivisions, int max_time,
+      int threads) {
+	printAdaptiveRules("TestData/hpAdaptive.csv", error, max_subdivisions,
+	      threads, { "MidpointRule::adaptiveNonParallel",
+	            "BoolesRule::adaptiveNestedNonParallel", "hpAdaptiveNewtonCotes",
+	            "BoolesRule::adaptiveNestedParallel",
+	            "hpAdaptiveNewtonCotesParallel", "adaptiveGaussLobatto" },
+	      [&](int rule, const auto &f, double a, double b, int *subdivisions,
+	            double *utilization) {
+		      switch (rule) {
+		      case 0:
+			      return MidpointRule::adaptiveNonParallel(f, a, b, error,
+			            max_subdivisions, max_time, subdivisions);
+		      case 1:
+			      return BoolesRule::adaptiveNestedNonParallel(f, a, b, error,
+			            max_subdivisions, max_time, subdivisions);
+		      case 2:
+			      return HpAdaptive::adaptiveNonParallel<deferredRepair>(f, a, b,
+			            error, max_subdivisions, max_time, subdivisions);
+		      case 3:
+			      return BoolesRule::adaptiveNestedParallel(f, a, b, threads,
+			            error, max_subdivisions, max_time, subdivisions,
+			            utilization);
+		      case 4:
+			      return HpAdaptive::adaptiveParallel<deferredRepair>(f, a, b,
+			            threads, error, max_subdivisions, max_time, subdivisions,
+			            utilization);
+		      default:
+			      return GaussLobatto::adaptiveNonParallel<deferredRepair>(f, a, b,
+			            error, max_subdivisions, max_time, subdivisions);
+		      }
+	      });
+}
+
+void printEmbeddedError(int subdivisionsFast, int subdivisionsSlow,
+      int threads) {
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/embeddedError.csv", std::fstream::out);
+
+	file << "Threads: " << threads << "\n";
+	file << "Estimates are asymptotic (Richardson) on smooth functions, and at "
+	      << "least the largest group's difference near singularities\n";
+	file << ",Rule,Integral,Subdivisions,Result,Error,Estimated Error,"
+	      << "Parallel Estimated Error,Extra Evaluations\n";
+	const char *names[] = { "Midpoint Rule", "Trapezoid Rule", "Simpson Rule",
+	      "Simpson 3/8 Rule", "Boole's Rule" };
+	for (int rule = 0; rule < 5; rule++) {
+		std::cout << "Calculating " << names[rule] << "... " << std::flush;
+		for (int subdivisions : { subdivisionsFast, subdivisionsSlow }) {
+			for (Functions::integrableFunction &function : functions.functions) {
+				batchFunction batch(function.batch, function.f.params, function.f);
+				std::atomic<long> evaluations;
+				auto counted = [&](double x) {
+					evaluations++;
+					return function.f.function(x, function.f.params);
+				};
+				double a = function.a;
+				double b = function.b;
+				auto integrate = [&](const auto &f, double *abserror) {
+					switch (rule) {
+					case 0:
+						return abserror ?
+						      MidpointRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions, abserror) :
+						      MidpointRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions);
+					case 1:
+						return abserror ?
+						      TrapezoidRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions, abserror) :
+						      TrapezoidRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions);
+					case 2:
+						return abserror ?
+						      SimpsonRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions, abserror) :
+						      SimpsonRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions);
+					case 3:
+						return abserror ?
+						      Simpson38Rule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions, abserror) :
+						      Simpson38Rule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions);
+					default:
+						return abserror ?
+						      BoolesRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions, abserror) :
+						      BoolesRule::nonAdaptiveNonParallel(f, a, b,
+						            subdivisions);
+					}
+				};
+				typedef double (*parallelRule)(const batchFunction&, double,
+				      double, int, int, double*);
+				parallelRule parallel[] = { MidpointRule::nonAdaptiveParallel,
+				      TrapezoidRule::nonAdaptiveParallel,
+				      SimpsonRule::nonAdaptiveParallel,
+				      Simpson38Rule::nonAdaptiveParallel,
+				      BoolesRule::nonAdaptiveParallel };
+
+				double abserror;
+				double value = integrate(batch, &abserror);
+				double parallelError;
+				parallel[rule](batch, a, b, subdivisions, threads, &parallelError);
+				evaluations = 0;
+				integrate(counted, NULL);
+				long plain = evaluations;
+				evaluations = 0;
+				double ignored;
+				integrate(counted, &ignored);
+				file << "," << names[rule] << "," << function.name << " from " << a
+				      << " to " << b << "," << subdivisions << "," << std::fixed
+				      << value << "," << std::scientific
+				      << fabs(value - function.value) << "," << abserror << ","
+				      << parallelError << "," << std::defaultfloat
+				      << evaluations - plain << std::endl;
+			}
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printFusedRules(int subdivisions, int threads) {
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/fusedRules.csv", std::fstream::out);
+
+	file << "Subdivisions: " << subdivisions << ",Threads: " << threads << "\n";
+	file << ",Integral,Separate Evaluations,Fused Evaluations,Separate (s),"
+	      << "Fused (s),Separate Parallel (s),Fused Parallel (s),"
+	      << "Max Difference\n";
+	for (Functions::integrableFunction &function : functions.functions) {
+		std::cout << "Calculating " << function.name << "... " << std::flush;
+		batchFunction batch(function.batch, function.f.params, function.f);
+		double a = function.a;
+		double b = function.b;
+		auto separate = [&](const auto &f, int num_threads) {
+			std::array<double, AllRules::RULES> values;
+			if (num_threads > 1) {
+				values = { { MidpointRule::nonAdaptiveParallel(f, a, b, subdivisions,
+				      num_threads), TrapezoidRule::nonAdaptiveParallel(f, a, b,
+				      subdivisions, num_threads), SimpsonRule::nonAdaptiveParallel(f,
+				      a, b, subdivisions, num_threads),
+				      Simpson38Rule::nonAdaptiveParallel(f, a, b, subdivisions,
+				            num_threads), BoolesRule::nonAdaptiveParallel(f, a, b,
+				            subdivisions, num_threads) } };
+			} else {
+				values = { { MidpointRule::nonAdaptiveNonParallel(f, a, b,
+				      subdivisions), TrapezoidRule::nonAdaptiveNonParallel(f, a, b,
+				      subdivisions), SimpsonRule::nonAdaptiveNonParallel(f, a, b,
+				      subdivisions), Simpson38Rule::nonAdaptiveNonParallel(f, a, b,
+				      subdivisions), BoolesRule::nonAdaptiveNonParallel(f, a, b,
+				      subdivisions) } };
+			}
+			return values;
+		};
+		auto fused = [&](const auto &f, int num_threads) {
+			return num_threads > 1 ?
+			      AllRules::nonAdaptiveParallel(f, a, b, subdivisions, num_threads) :
+			      AllRules::nonAdaptiveNonParallel(f, a, b, subdivisions);
+		};
+		auto time = [&](const auto &integrate, int num_threads,
+		      std::array<double, AllRules::RULES> *values) {
+			std::chrono::steady_clock::time_point start =
+			      std::chrono::steady_clock::now();
+			(*values) = integrate(batch, num_threads);
+			std::chrono::duration<double> duration =
+			      std::chrono::steady_clock::now() - start;
+			return duration.count();
+		};
+
+		std::array<double, AllRules::RULES> separateValues;
+		std::array<double, AllRules::RULES> fusedValues;
+		double seconds[4];
+		seconds[0] = time(separate, 1, &separateValues);
+		seconds[1] = time(fused, 1, &fusedValues);
+		double difference = 0;
+		for (int r = 0; r < AllRules::RULES; r++) {
+			difference = std::max(difference,
+			      fabs(separateValues[r] - fusedValues[r]));
+		}
+		seconds[2] = time(separate, threads, &separateValues);
+		seconds[3] = time(fused, threads, &fusedValues);
+
+		long evaluations = 0;
+		auto counted = [&](double x) {
+			evaluations++;
+			return function.f.function(x, function.f.params);
+		};
+		separate(counted, 1);
+		long separateEvaluations = evaluations;
+		evaluations = 0;
+		fused(counted, 1);
+		file << "," << function.name << " from " << a << " to " << b << ","
+		      << separateEvaluations << "," << evaluations << "," << std::fixed
+		      << seconds[0] << "," << seconds[1] << "," << seconds[2] << ","
+		      << seconds[3] << "," << std::scientific << difference
+		      << std::defaultfloat << std::endl;
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
+
+void printExtrapolated(double error, int max_subdivisions, int threads) {
+	Functions functions;
+	std::fstream file;
+	file.open("TestData/extrapolated.csv", std::fstream::out);
+
+	file << "Error: " << error << ",Max Subdivisions: " << max_subdivisions
+	      << ",Threads: " << threads << "\n";
+	file << ",Rule,Integral,Extrapolation,Result,Actual Error,Estimated Error,"
+	      << "Evaluations,Time (s),Parallel Time (s)\n";
+	const char *names[] = { "Midpoint Rule", "Trapezoid Rule", "Simpson Rule",
+	      "Simpson 3/8 Rule", "Boole's Rule" };
+	const int points[] = { 1, 1, 2, 3, 4 }; // per subdivision, besides the end
+	typedef double (*extrapolatedRule)(const batchFunction&, double, double,
+	      double, int, int, bool, int*, double*);
+	extrapolatedRule extrapolated[] = { MidpointRule::extrapolated,
+	      TrapezoidRule::extrapolated, SimpsonRule::extrapolated,
+	      Simpson38Rule::extrapolated, BoolesRule::extrapolated };
+	typedef double (*compositeRule)(const batchFunction&, double, double, int);
+	compositeRule composite[] = { MidpointRule::nonAdaptiveNonParallel,
+	      TrapezoidRule::nonAdaptiveNonParallel,
+	      SimpsonRule::nonAdaptiveNonParallel,
+	      Simpson38Rule::nonAdaptiveNonParallel,
+	      BoolesRule::nonAdaptiveNonParallel };
+	for (int rule = 0; rule < 5; rule++) {
+		std::cout << "Calculating " << names[rule] << "... " << std::flush;
+		for (Functions::integrableFunction &function : functions.functions) {
+			batchFunction batch(function.batch, function.f.params, function.f);
+			double a = function.a;
+			double b = function.b;
+			auto print = [&](const char *extrapolation, double value,
+			      double abserror, long evaluations, double seconds,
+			      double parallelSeconds) {
+				file << "," << names[rule] << "," << function.name << " from " << a
+				      << " to " << b << "," << extrapolation << "," << std::fixed
+				      << value << "," << std::scientific
+				      << fabs(value - function.value) << ",";
+				if (abserror >= 0)
+					file << abserror;
+				file << "," << std::defaultfloat << evaluations << ","
+				      << std::fixed << seconds << ",";
+				if (parallelSeconds >= 0)
+					file << parallelSeconds;
+				file << std::defaultfloat << std::endl;
+			};
+			for (bool epsilon : { false, true }) {
+				double seconds[2];
+				double abserror;
+				int subdivisions;
+				double value = 0;
+				for (int t : { 1, threads }) {
+					value = timeIntegral([&](const batchFunction &f) {
+						return extrapolated[rule](f, a, b, error, max_subdivisions, t,
+						      epsilon, &subdivisions, &abserror);
+					}, batch, &seconds[t == 1 ? 0 : 1]);
+				}
+				print(epsilon ? "Wynn's Epsilon" : "Richardson", value, abserror,
+				      (long) points[rule] * subdivisions + (rule > 0), seconds[0],
+				      seconds[1]);
+			}
+
+			// the composite rule alone, at the most subdivisions
+			double seconds;
+			double value = timeIntegral([&](const batchFunction &f) {
+				return composite[rule](f, a, b, max_subdivisions);
+			}, batch, &seconds);
+			print("None", value, -1,
+			      (long) points[rule] * max_subdivisions + (rule > 0), seconds, -1);
+		}
+		std::cout << "done." << std::endl;
+	}
+	file.close();
+}
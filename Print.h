@@ -9,13 +9,16 @@
 #include <iostream>
 #include <fstream>
 #include <math.h>
+#include <float.h>
 #include <ctime>
 #include <sstream>
+#include <chrono>
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_errno.h>
 #include "Functions.h"
 #include "NewtonCotesRules/RuleHeaders.h"
 #include "AdvancedRules/AdvancedRules.h"
+#include "ThreadPool.h"
 
 /**
  * Prints the outputs of the Non Adaptive Non Parallel version of the Newton-Cotes rules to csv files.
@@ -82,4 +85,206 @@ void printAdaptiveParallel(int max_subdivisions, int timeFast, int timeSlow,
 void printAdvanced(int max_subdivisions, double errorFast, double errorSlow,
       int pointsFast, int pointsSlow, int keyFast, int keySlow, int threads);
 
+/**
+ * Prints the outputs of the globally adaptive versions of the Newton-Cotes rules to csv files,
+ * serial and parallel, with and without Richardson extrapolation of each interval.
+ * Two tests are done with faster and slower parameters, printing to adaptiveGlobalFast.csv
+ * and adaptiveGlobalAccurate.csv
+ * @param max_subdivisions the maximum subdivisions to be used for the test
+ * @param timeFast the time limit for the faster test
+ * @param timeSlow the time limit for the slower (more accurate) test
+ * @param errorFast the (absolute) error goal for the faster test
+ * @param errorSlow the (absolute) error goal for the slower (more accurate) test
+ * @param threads the number of threads to run in parallel
+ */
+void printAdaptiveGlobal(int max_subdivisions, int timeFast, int timeSlow,
+      double errorFast, double errorSlow, int threads);
+/**
+ * Prints the per-call latency of the parallel rules when run on the shared thread pool
+ * and when spawning new threads on every call, to threadPool.csv.
+ * Each rule integrates every function repetitions times with each method.
+ * @param subdivisions the number of subdivisions (or points, for Gauss-Legendre) to use
+ * @param threads the number of threads to run in parallel
+ * @param repetitions the number of times to integrate each function
+ */
+void printThreadPool(int subdivisions, int threads, int repetitions);
+/**
+ * Compares the vectorised (batched) versions of the functions with the scalar versions,
+ * printing to vectorFunctions.csv. Accuracy is checked by integrating each with Boole's
+ * Rule against the symbolic value, and by the largest relative difference between the
+ * two at points across the interval. Throughput is the number of evaluations per second
+ * on one core, in blocks of BATCH_SIZE.
+ * @param subdivisions the number of subdivisions for the integrals
+ * @param points the number of points to evaluate
+ * @param repetitions the number of times to evaluate the points
+ */
+void printVectorFunctions(int subdivisions, int points, int repetitions);
+/**
+ * Compares passing the functions x^2 and 3*x^4+4*x^3+76*x^2+58*x+4 to the rules as a
+ * gsl_function, as a batchFunction and as a lambda (which the rules' templates inline),
+ * printing the time for each to callableFunctions.csv. The lambdas are written as the
+ * batch versions are (x*x and Horner's form).
+ * @param subdivisions the number of subdivisions to use
+ * @param threads the number of threads to run in parallel
+ */
+void printCallableFunctions(int subdivisions, int threads);
+/**
+ * Compares the evaluation policies of the rules on every function with Boole's Rule,
+ * printing to evaluationPolicy.csv. Every function is integrated with deferredRepair,
+ * counting the values which had to be repaired (and the extra evaluations this took),
+ * and the well behaved functions are also integrated with the unchecked policy.
+ * @param subdivisions the number of subdivisions to use
+ * @param repetitions the number of times to integrate each function
+ */
+void printEvaluationPolicy(int subdivisions, int repetitions);
+/**
+ * Prints the latency of gaussLegendreFixed with the shared table cache against computing
+ * (and freeing) the table on every call, for repeated small integrals of every function,
+ * to gaussLegendreCache.csv. The composite gaussLegendreFixedParallel is then run with
+ * each number of threads up to threads, whose results should all agree.
+ * @param pointsFast the smaller number of points
+ * @param pointsSlow the larger number of points
+ * @param threads the largest number of threads to run in parallel
+ * @param repetitions the number of times to integrate each function
+ */
+void printGaussLegendreCache(int pointsFast, int pointsSlow, int threads,
+      int repetitions);
+/**
+ * Prints the throughput of a batch of adaptive Gauss-Kronrod integrals (qag and qags)
+ * using each thread's pooled workspace, against allocating and freeing a workspace
+ * for every integral, to workspacePool.csv. The integrals cycle through the functions.
+ * @param max_subdivisions the maximum subdivisions (the size of each workspace)
+ * @param error the error goal
+ * @param integrals the number of integrals in the batch
+ */
+void printWorkspacePool(int max_subdivisions, double error, int integrals);
+/**
+ * Prints the composite Gauss-Kronrod rules (each key) using GSL's qk routines
+ * against the native kernels in GaussKronrod.h (with each function's batch
+ * version), to gaussKronrodKernels.csv: their results and error estimates, which
+ * should agree, and the time each takes per panel.
+ * @param panels the number of panels for each integral
+ */
+void printGaussKronrodKernels(int panels);
+/**
+ * Prints the globally adaptive Gauss-Kronrod rules with a shared error budget
+ * (qag-like, and qags-like with extrapolation) on 1 and threads threads against
+ * GSL's serial qag and qags, to parallelGaussKronrod.csv: the result, its actual
+ * and estimated errors, and the wall time, for the badly behaved functions.
+ * @param error the error goal
+ * @param max_subdivisions the maximum subdivisions to use
+ * @param threads the number of threads to run in parallel
+ */
+void printParallelGaussKronrod(double error, int max_subdivisions, int threads);
+/**
+ * Prints how evenly equal-width pieces and the pieces of balancedPartition() share
+ * the work of a globally adaptive Gauss-Kronrod rule, to partitionBalance.csv.
+ * Each piece is integrated on its own to its share of the error goal, and the
+ * imbalance is the largest piece's subdivisions over the mean (1 is perfectly balanced).
+ * @param error the error goal for the whole integral
+ * @param max_subdivisions the maximum subdivisions for each piece
+ * @param threads the number of pieces
+ */
+void printPartitionBalance(double error, int max_subdivisions, int threads);
+/**
+ * Prints the evaluations and time each rule needs to reach the error goal on the
+ * simple functions, to clenshawCurtis.csv: the nested Clenshaw-Curtis rule (by its
+ * own error estimate), and Gauss-Legendre and Boole's rule with their points or
+ * subdivisions doubled until they reach it (against the known value), counting
+ * the evaluations and time of every try.
+ * @param error the error goal (absolute, or relative to the integral)
+ * @param max_points the most points to use
+ */
+void printClenshawCurtis(double error, int max_points);
+/**
+ * Prints the time to create Gauss-Legendre tables of increasing size (from 1000
+ * points, by factors of 10) with GSL's Newton iteration and with the O(n)
+ * expansions of GaussLegendre.h, on 1 and threads threads, to gaussLegendreNodes.csv.
+ * The generated nodes and weights are compared with GSL's, and the largest relative
+ * error of the table on the simple functions is printed.
+ * @param max_points the most points to generate
+ * @param max_gsl_points the most points to create with GSL (which takes O(n^2) time)
+ * @param threads the number of threads to run in parallel
+ */
+void printGaussLegendreNodes(int max_points, int max_gsl_points, int threads);
+/**
+ * Prints Romberg integration (on 1 and threads threads) against Boole's rule on
+ * every function, to romberg.csv: the result, its actual and estimated errors, the
+ * evaluations and the time. Boole's rule has its subdivisions doubled until it is
+ * as accurate as Romberg integration (or meets the error goal).
+ * @param error the (absolute) error goal
+ * @param max_subdivisions the maximum subdivisions to use
+ * @param threads the number of threads to run in parallel
+ */
+void printRomberg(double error, int max_subdivisions, int threads);
+/**
+ * Prints the adaptive Gauss-Lobatto rule (serial and on threads threads) against
+ * BoolesRule::adaptiveParallel on every function, to gaussLobatto.csv: the result,
+ * its error, the time, the subdivisions and evaluations, and the utilization.
+ * @param error the error goal
+ * @param max_subdivisions the maximum subdivisions to use
+ * @param max_time the time limit for each integral
+ * @param threads the number of threads to run in parallel
+ */
+void printGaussLobatto(double error, int max_subdivisions, int max_time,
+      int threads);
+/**
+ * Prints the adaptive Simpson's 3/8 and Boole's rules against their variants with
+ * nested intervals (serial, and on threads threads) on every function, to
+ * nestedAdaptive.csv: the result, its error, the time, and the subdivisions and
+ * evaluations each needs at the same error goal.
+ * @param error the error goal
+ * @param max_subdivisions the maximum subdivisions to use
+ * @param max_time the time limit for each integral
+ * @param threads the number of threads to run in parallel
+ */
+void printNestedAdaptive(double error, int max_subdivisions, int max_time,
+      int threads);
+/**
+ * Prints the hp-adaptive Newton-Cotes rule against the adaptive midpoint rule, the
+ * nested adaptive Boole's rule (serial, and on threads threads) and the adaptive
+ * Gauss-Lobatto rule on every function, to hpAdaptive.csv: the result, its error,
+ * the time, and the subdivisions and evaluations each needs at the same error goal
+ * (e^x*ln(sin(x)), whose values near pi are only noise, shows whether the
+ * hp-adaptive rule stops dividing where it cannot improve).
+ * @param error the error goal
+ * @param max_subdivisions the maximum subdivisions to use
+ * @param max_time the time limit for each integral
+ * @param threads the number of threads to run in parallel
+ */
+void printHpAdaptive(double error, int max_subdivisions, int max_time,
+      int threads);
+/**
+ * Prints each composite Newton-Cotes rule's error estimate (serial, and on threads
+ * threads) against its actual error on every function, to embeddedError.csv, with
+ * the number of evaluations the estimate adds. The estimate is asymptotic, so it
+ * is only close on smooth functions; near a singularity it is the largest group's
+ * difference, which is within a few times the actual error.
+ * @param subdivisionsFast the number of subdivisions for the fast test
+ * @param subdivisionsSlow the number of subdivisions for the accurate test
+ * @param threads the number of threads to run in parallel
+ */
+void printEmbeddedError(int subdivisionsFast, int subdivisionsSlow,
+      int threads);
+/**
+ * Prints the five composite Newton-Cotes rules run one by one against the fused
+ * AllRules versions on every function, to fusedRules.csv: the evaluations and time
+ * (serial, and on threads threads) each takes, and the largest difference between
+ * their results
+ * @param subdivisions the number of subdivisions to use
+ * @param threads the number of threads to run in parallel
+ */
+void printFusedRules(int subdivisions, int threads);
+/**
+ * Prints each composite Newton-Cotes rule extrapolated over a geometric sequence of
+ * subdivisions, with Richardson extrapolation and with Wynn's epsilon algorithm,
+ * against the rule alone at max_subdivisions subdivisions on every function, to
+ * extrapolated.csv: the result, its actual and estimated errors, the evaluations
+ * used, and the time taken (on 1 and threads threads)
+ * @param error the (absolute) error goal
+ * @param max_subdivisions the maximum number of subdivisions to use
+ * @param threads the number of threads to run in parallel
+ */
+void printExtrapolated(double error, int max_subdivisions, int threads);
+
 #endif /* PRINT_H_ */
@@ -0,0 +1,146 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implements the process-wide pool of worker threads
+ * @author Irene Crowell
+ */
+#include "ThreadPool.h"
+#include <atomic>
+
+namespace {
+/**
+ * Whether run() submits to the pool (true) or spawns a thread per task (false)
+ */
+std::atomic<bool> pooling(true);
+}
+
+/**
+ * Gets the pool shared by the whole process, starting it on first use
+ * @return the shared pool
+ */
+ThreadPool &ThreadPool::getInstance() {
+	static ThreadPool pool;
+	return pool;
+}
+
+/**
+ * Starts one worker per hardware thread, less the caller (which also runs tasks)
+ */
+ThreadPool::ThreadPool() :
+		idle(0), stopping(false) {
+	int hardware = std::thread::hardware_concurrency();
+	reserve(hardware > 1 ? hardware - 1 : 1);
+}
+
+/**
+ * Stops and joins all of the workers
+ */
+ThreadPool::~ThreadPool() {
+	tasks_mutex.lock();
+	stopping = true;
+	tasks_mutex.unlock();
+	tasks_available.notify_all();
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+}
+
+/**
+ * Starts workers until at least num_workers are running, so the first
+ * calls do not pay for starting threads.
+ * @param num_workers the number of workers to have running
+ */
+void ThreadPool::reserve(int num_workers) {
+	std::lock_guard<std::mutex> lock(tasks_mutex);
+	while ((int) workers.size() < num_workers) {
+		spawnWorker();
+	}
+}
+
+/**
+ * Starts one more worker. Must be called with tasks_mutex held.
+ */
+void ThreadPool::spawnWorker() {
+	idle++;
+	workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+/**
+ * Runs on each worker -- takes tasks from the queue until the pool is stopped
+ */
+void ThreadPool::workerLoop() {
+	std::unique_lock<std::mutex> lock(tasks_mutex);
+	while (true) {
+		tasks_available.wait(lock, [this] {return stopping || !tasks.empty();});
+		if (tasks.empty())
+			return; // stopping, and nothing left to run
+		std::function<void()> task = std::move(tasks.front());
+		tasks.pop();
+		idle--;
+		lock.unlock();
+		task();
+		lock.lock();
+		idle++;
+	}
+}
+
+/**
+ * Runs task(0) ... task(num_tasks-1) concurrently and waits for all of them.
+ * The calling thread runs task(0) itself, and workers are added if there are not
+ * enough idle ones, so tasks which wait on each other cannot deadlock.
+ * @param num_tasks the number of tasks to run
+ * @param task the task to run, given its number (0 to num_tasks-1)
+ */
+void ThreadPool::run(int num_tasks, const std::function<void(int)> &task) {
+	if (num_tasks <= 0)
+		return;
+	if (!pooling) { // spawn-per-call path, kept for comparison
+		std::vector<std::thread> threads;
+		for (int i = 0; i < num_tasks; i++) {
+			threads.push_back(std::thread(task, i));
+		}
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+		return;
+	}
+
+	std::mutex done_mutex;
+	std::condition_variable done;
+	int remaining = num_tasks - 1;
+
+	tasks_mutex.lock();
+	while (idle - (int) tasks.size() < num_tasks - 1) {
+		spawnWorker();
+	}
+	for (int i = 1; i < num_tasks; i++) {
+		tasks.push([&task, i, &done_mutex, &done, &remaining] {
+			task(i);
+			std::lock_guard<std::mutex> lock(done_mutex);
+			if (--remaining == 0)
+				done.notify_one();
+		});
+	}
+	tasks_mutex.unlock();
+	tasks_available.notify_all();
+
+	task(0);
+
+	std::unique_lock<std::mutex> lock(done_mutex);
+	done.wait(lock, [&remaining] {return remaining == 0;});
+}
+
+/**
+ * Chooses between submitting to the pool and spawning a thread per task
+ * (the original behaviour, for benchmarking)
+ * @param pool true to use the pool
+ */
+void ThreadPool::setPooling(bool pool) {
+	pooling = pool;
+}
+
+/**
+ * @return true if run() submits to the pool
+ */
+bool ThreadPool::isPooling() {
+	return pooling;
+}
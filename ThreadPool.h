@@ -0,0 +1,47 @@
+/**
+ * @file ThreadPool.h
+ * @brief Contains the process-wide pool of worker threads used by the parallel rules
+ * @author Irene Crowell
+ */
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/**
+ * A pool of pre-started worker threads shared by every parallel rule.
+ * Spawning and joining threads for each integral costs more than the integral
+ * itself for small problems, so the rules submit their sections to this pool instead.
+ */
+class ThreadPool {
+public:
+	static ThreadPool &getInstance();
+	~ThreadPool();
+
+	void run(int num_tasks, const std::function<void(int)> &task);
+	void reserve(int num_workers);
+
+	static void setPooling(bool pool);
+	static bool isPooling();
+
+private:
+	ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	void spawnWorker();
+	void workerLoop();
+
+	std::vector<std::thread> workers; //!<the started worker threads
+	std::queue<std::function<void()>> tasks; //!<tasks waiting for a worker
+	std::mutex tasks_mutex; //!<guards tasks, idle and stopping
+	std::condition_variable tasks_available; //!<signalled when a task is queued
+	int idle; //!<the number of workers not running a task
+	bool stopping; //!<set when the pool is being destroyed
+};
+
+#endif /* THREADPOOL_H_ */
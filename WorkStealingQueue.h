@@ -0,0 +1,219 @@
+/**
+ * @file WorkStealingQueue.h
+ * @brief Contains the per-thread work queues shared by the parallel adaptive rules
+ * @author Irene Crowell
+ */
+#ifndef WORKSTEALINGQUEUE_H_
+#define WORKSTEALINGQUEUE_H_
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+/**
+ * A set of work queues, one per thread.
+ * Each thread pushes and pops at the back of its own queue (so it refines its own
+ * intervals depth-first, without contention), and only when its queue is empty
+ * does it steal from the front of another thread's queue (taking the largest,
+ * oldest intervals, which carry the most work).
+ *
+ * A thread is busy from a successful pop() until its next call of pop(), so the
+ * items it pushes in between are the work it produced. Only a thread which finds
+ * every queue empty touches the shared state: it counts itself idle and sleeps
+ * until more work is pushed, and the queue is done once every thread is idle
+ * with nothing queued. Pushing and popping otherwise only touch the thread's
+ * own queue.
+ */
+template<typename T>
+class WorkStealingQueue {
+public:
+	explicit WorkStealingQueue(int num_workers);
+
+	void push(int worker, const T &item);
+	bool pop(int worker, T *item);
+	long size() const;
+	double utilization() const;
+
+private:
+	typedef std::chrono::steady_clock clock;
+
+	bool tryPop(int worker, T *item);
+	bool queued() const;
+
+	/**
+	 * One thread's queue and timings, padded so neighbouring queues do not
+	 * share a cache line
+	 */
+	struct workerQueue {
+		std::mutex mutex; //!<guards items
+		std::deque<T> items; //!<the queued work, newest at the back
+		std::atomic<long> length { 0 }; //!<items.size(), readable without the lock
+		bool started = false; //!<whether the thread has called pop() yet
+		clock::time_point first; //!<when the thread first called pop()
+		clock::time_point last; //!<when the thread found no work left
+		clock::duration waiting = clock::duration::zero(); //!<time spent looking for work
+		char padding[64]; //!<keeps the next queue's mutex off this cache line
+	};
+
+	int num_workers; //!<the number of threads (and queues)
+	std::unique_ptr<workerQueue[]> queues; //!<the queue for each thread
+	std::atomic<int> sleepers; //!<the number of threads waiting for work
+	std::mutex sleep_mutex; //!<guards idle, done and sleeping
+	int idle; //!<the number of threads which found every queue empty
+	bool done; //!<whether every thread was idle with nothing queued
+	std::condition_variable sleeping; //!<signalled when work is pushed or all work is done
+	clock::time_point created; //!<when the queue was created
+};
+
+/**
+ * @param num_workers the number of threads which will use the queue
+ */
+template<typename T>
+WorkStealingQueue<T>::WorkStealingQueue(int num_workers) :
+		num_workers(num_workers), queues(new workerQueue[num_workers]),
+		      sleepers(0), idle(0), done(false), created(clock::now()) {
+}
+
+/**
+ * Adds an item to the back of a thread's own queue, waking a sleeping thread
+ * @param worker the thread adding the item (0 to num_workers-1)
+ * @param item the item to add
+ */
+template<typename T>
+void WorkStealingQueue<T>::push(int worker, const T &item) {
+	{
+		std::lock_guard<std::mutex> lock(queues[worker].mutex);
+		queues[worker].items.push_back(item);
+		queues[worker].length++;
+	}
+	// a sleeper counts itself before checking the lengths, so either it sees this
+	// item or this sees it
+	if (sleepers > 0) {
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		sleeping.notify_one();
+	}
+}
+
+/**
+ * Takes the newest item from a thread's own queue, or steals the oldest
+ * item from another thread's queue if its own is empty.
+ * @param worker the thread taking the item (0 to num_workers-1)
+ * @param [out] item the item taken
+ * @return false if every queue was empty
+ */
+template<typename T>
+bool WorkStealingQueue<T>::tryPop(int worker, T *item) {
+	{
+		std::lock_guard<std::mutex> lock(queues[worker].mutex);
+		if (!queues[worker].items.empty()) {
+			*item = queues[worker].items.back();
+			queues[worker].items.pop_back();
+			queues[worker].length--;
+			return true;
+		}
+	}
+	for (int i = 1; i < num_workers; i++) {
+		workerQueue &victim = queues[(worker + i) % num_workers];
+		if (victim.length == 0)
+			continue; // skip empty queues without taking their lock
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.items.empty()) {
+			*item = victim.items.front();
+			victim.items.pop_front();
+			victim.length--;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @return true if any queue has an item
+ */
+template<typename T>
+bool WorkStealingQueue<T>::queued() const {
+	for (int i = 0; i < num_workers; i++) {
+		if (queues[i].length > 0)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Takes an item as tryPop() does, sleeping while every queue is empty but
+ * other threads are still busy (and may produce more work).
+ * @param worker the thread taking the item (0 to num_workers-1)
+ * @param [out] item the item taken
+ * @return false once every thread is idle with nothing queued
+ */
+template<typename T>
+bool WorkStealingQueue<T>::pop(int worker, T *item) {
+	workerQueue &own = queues[worker];
+	clock::time_point looking = clock::now();
+	if (!own.started) {
+		own.started = true;
+		own.first = looking;
+	}
+	while (!tryPop(worker, item)) {
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		idle++;
+		sleepers++;
+		while (!done && !queued()) {
+			if (idle == num_workers) { // nobody is left to push more work
+				done = true;
+				sleeping.notify_all();
+				break;
+			}
+			sleeping.wait(lock);
+		}
+		sleepers--;
+		if (done) {
+			lock.unlock();
+			own.last = clock::now();
+			own.waiting += own.last - looking;
+			return false;
+		}
+		idle--;
+	}
+	own.waiting += clock::now() - looking;
+	return true;
+}
+
+/**
+ * @return the number of items queued across all threads
+ */
+template<typename T>
+long WorkStealingQueue<T>::size() const {
+	long total = 0;
+	for (int i = 0; i < num_workers; i++) {
+		total += queues[i].length;
+	}
+	return total;
+}
+
+/**
+ * Finds the fraction of the threads' time spent working rather than looking
+ * for work, from the creation of the queue until the last thread finished.
+ * Should only be called once every thread's pop() has returned false.
+ * @return the utilization, from 0 to 1
+ */
+template<typename T>
+double WorkStealingQueue<T>::utilization() const {
+	clock::time_point end = created;
+	clock::duration busy = clock::duration::zero();
+	for (int i = 0; i < num_workers; i++) {
+		if (!queues[i].started)
+			continue;
+		if (queues[i].last > end)
+			end = queues[i].last;
+		busy += (queues[i].last - queues[i].first) - queues[i].waiting;
+	}
+	if (end == created)
+		return 0;
+	return std::chrono::duration<double>(busy).count()
+	      / (num_workers * std::chrono::duration<double>(end - created).count());
+}
+
+#endif /* WORKSTEALINGQUEUE_H_ */
@@ -15,14 +15,18 @@ int main() {
 	double errorSlow = 1e-6;
 	int subdivisionsFast = 1e2;
 	int subdivisionsSlow = 1e5;
+	int subdivisionsCallable = 1e8;
 	int timeFast = 1;
 	int timeSlow = 5;
 	int pointsFast = 3;
 	int pointsSlow = 6;
 	int keyFast = GSL_INTEG_GAUSS15;
 	int keySlow = GSL_INTEG_GAUSS61;
+	int repetitions = 100;
+	int integrals = 5000;
 
 	std::cout << "running..." << std::endl;
+	ThreadPool::getInstance().reserve(threads);
 
 	std::cout << std::endl << "NonAdaptiveNonParallel" << std::endl;
 	printNonAdaptiveNonParallel(subdivisionsFast, subdivisionsSlow);
@@ -37,10 +41,69 @@ int main() {
 	std::cout << std::endl << "AdaptiveParallel" << std::endl;
 	printAdaptiveParallel(subdivisionsSlow, timeFast, timeSlow, errorFast,
 	      errorSlow, threads);
+
+	std::cout << std::endl << "AdaptiveGlobal" << std::endl;
+	printAdaptiveGlobal(subdivisionsSlow, timeFast, timeSlow, errorFast,
+	      errorSlow, threads);
+
 	std::cout << std::endl << "All GSL" << std::endl;
 	printAdvanced(subdivisionsSlow, errorFast, errorSlow, pointsFast, pointsSlow,
 	      keyFast, keySlow, threads);
 
+	std::cout << std::endl << "Thread Pool" << std::endl;
+	printThreadPool(subdivisionsFast, threads, repetitions);
+
+	std::cout << std::endl << "Vector Functions" << std::endl;
+	printVectorFunctions(subdivisionsSlow, subdivisionsSlow, repetitions);
+
+	std::cout << std::endl << "Callable Functions" << std::endl;
+	printCallableFunctions(subdivisionsCallable, threads);
+
+	std::cout << std::endl << "Evaluation Policy" << std::endl;
+	printEvaluationPolicy(subdivisionsSlow, repetitions);
+
+	std::cout << std::endl << "Gauss-Legendre Cache" << std::endl;
+	printGaussLegendreCache(pointsFast, pointsSlow, threads, repetitions);
+
+	std::cout << std::endl << "Workspace Pool" << std::endl;
+	printWorkspacePool(subdivisionsSlow, errorFast, integrals);
+
+	std::cout << std::endl << "Gauss-Kronrod Kernels" << std::endl;
+	printGaussKronrodKernels(subdivisionsSlow);
+
+	std::cout << std::endl << "Parallel Gauss-Kronrod" << std::endl;
+	printParallelGaussKronrod(errorSlow, subdivisionsSlow, threads);
+
+	std::cout << std::endl << "Partition Balance" << std::endl;
+	printPartitionBalance(errorSlow, subdivisionsSlow, threads);
+
+	std::cout << std::endl << "Clenshaw-Curtis" << std::endl;
+	printClenshawCurtis(1e-12, subdivisionsSlow);
+
+	std::cout << std::endl << "Gauss-Legendre Nodes" << std::endl;
+	printGaussLegendreNodes(1e6, 1e4, threads);
+
+	std::cout << std::endl << "Romberg" << std::endl;
+	printRomberg(errorSlow, subdivisionsSlow, threads);
+
+	std::cout << std::endl << "Gauss-Lobatto" << std::endl;
+	printGaussLobatto(errorSlow, subdivisionsSlow, timeSlow, threads);
+
+	std::cout << std::endl << "Nested Adaptive" << std::endl;
+	printNestedAdaptive(errorSlow, subdivisionsSlow, timeSlow, threads);
+
+	std::cout << std::endl << "hp-Adaptive" << std::endl;
+	printHpAdaptive(errorSlow, subdivisionsSlow, timeSlow, threads);
+
+	std::cout << std::endl << "Embedded Error" << std::endl;
+	printEmbeddedError(subdivisionsFast, subdivisionsSlow, threads);
+
+	std::cout << std::endl << "Fused Rules" << std::endl;
+	printFusedRules(subdivisionsSlow, threads);
+
+	std::cout << std::endl << "Extrapolated" << std::endl;
+	printExtrapolated(1e-10, subdivisionsSlow, threads);
+
 	std::cout << "done" << std::endl;
 	return 0;
 }